@@ -0,0 +1,94 @@
+#include "CachedRowSource.h"
+#include <algorithm>
+
+CachedRowSource::CachedRowSource(std::shared_ptr<RowSource> source, int pageRows, qint64 maxCachedCells)
+    : _source(std::move(source))
+    , _pageRows(std::max(pageRows, 1))
+{
+    // The budget is in cells, so wide tables cache fewer pages.
+    const qint64 pageCells = static_cast<qint64>(_pageRows) * std::max(_source->colCount(), 1);
+    _maxPages = static_cast<int>(std::max<qint64>(2, maxCachedCells / pageCells));
+}
+
+CachedRowSource::Page CachedRowSource::lookup(int index) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _pages.find(index);
+    if (it == _pages.end())
+        return nullptr;
+    _lru.splice(_lru.begin(), _lru, it->second.second);
+    return it->second.first;
+}
+
+void CachedRowSource::insert(int index, const Page& page) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_pages.find(index) != _pages.end())
+        return;
+    _lru.push_front(index);
+    _pages.emplace(index, std::make_pair(page, _lru.begin()));
+    while (static_cast<int>(_pages.size()) > _maxPages) {
+        _pages.erase(_lru.back());
+        _lru.pop_back();
+    }
+}
+
+CachedRowSource::Page CachedRowSource::page(int index) const
+{
+    if (auto cached = lookup(index))
+        return cached;
+
+    // Read without holding the lock, so a slow prefetch never blocks the GUI thread on another page.
+    const int first = index * _pageRows;
+    const int count = std::min(_pageRows, rowCount() - first);
+    auto values = std::make_shared<std::vector<FastTableData::Value>>();
+    if (count <= 0 || !_source->readRows(first, count, *values))
+        return nullptr;
+
+    Page loaded = std::move(values);
+    insert(index, loaded);
+    return loaded;
+}
+
+bool CachedRowSource::readRows(int first, int count, std::vector<FastTableData::Value>& out) const
+{
+    if (first < 0 || count < 0 || first + count > rowCount())
+        return false;
+
+    const int cols = colCount();
+    out.resize(static_cast<size_t>(count) * cols);
+
+    int row = first;
+    while (row < first + count) {
+        const int index = row / _pageRows;
+        const auto values = page(index);
+        if (!values)
+            return false;
+        const int pageFirst = index * _pageRows;
+        const int take = std::min(first + count, pageFirst + _pageRows) - row;
+        std::copy_n(values->begin() + static_cast<size_t>(row - pageFirst) * cols, static_cast<size_t>(take) * cols,
+            out.begin() + static_cast<size_t>(row - first) * cols);
+        row += take;
+    }
+    return true;
+}
+
+void CachedRowSource::warm(int first, int count) const
+{
+    first = std::max(first, 0);
+    const int last = std::min(first + count, rowCount()) - 1;
+    for (int index = first / _pageRows; index <= last / _pageRows && last >= first; ++index)
+        page(index);
+}
+
+bool CachedRowSource::isCached(int first, int count) const
+{
+    first = std::max(first, 0);
+    const int last = std::min(first + count, rowCount()) - 1;
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (int index = first / _pageRows; index <= last / _pageRows && last >= first; ++index) {
+        if (_pages.find(index) == _pages.end())
+            return false;
+    }
+    return true;
+}
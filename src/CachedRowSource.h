@@ -0,0 +1,48 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "RowSource.h"
+
+// Thread-safe LRU of fixed-size row pages in front of a slower RowSource.
+// Pages can be warmed from a worker thread ahead of use, reads then assemble rows from memory.
+class CachedRowSource : public RowSource {
+public:
+    explicit CachedRowSource(std::shared_ptr<RowSource> source, int pageRows = 1024, qint64 maxCachedCells = 2000000);
+
+    int rowCount() const override { return _source->rowCount(); }
+    int colCount() const override { return _source->colCount(); }
+
+    QString columnName(int col) const override { return _source->columnName(col); }
+    bool columnIsNumeric(int col) const override { return _source->columnIsNumeric(col); }
+    void getColumnMinMax(int col, double& minVal, double& maxVal) const override { _source->getColumnMinMax(col, minVal, maxVal); }
+    std::map<QString, QColor> columnLabelColors(int col) const override { return _source->columnLabelColors(col); }
+
+    bool readRows(int first, int count, std::vector<FastTableData::Value>& out) const override;
+
+    std::shared_ptr<RowSource> underlying() const { return _source; }
+    int pageRows() const { return _pageRows; }
+    int maxPages() const { return _maxPages; }
+
+    // Loads the pages covering [first, first + count) that are not cached yet.
+    void warm(int first, int count) const;
+    bool isCached(int first, int count) const;
+
+private:
+    using Page = std::shared_ptr<const std::vector<FastTableData::Value>>;
+
+    Page page(int index) const;
+    Page lookup(int index) const;
+    void insert(int index, const Page& page) const;
+
+    std::shared_ptr<RowSource> _source;
+    int _pageRows;
+    int _maxPages;
+
+    mutable std::mutex _mutex;
+    mutable std::list<int> _lru; // most recently used first
+    mutable std::unordered_map<int, std::pair<Page, std::list<int>::iterator>> _pages;
+};
@@ -0,0 +1,113 @@
+#include "ClipboardCopier.h"
+#include "TableTextFormat.h"
+#include <QApplication>
+#include <QClipboard>
+#include <QMimeData>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <optional>
+
+namespace {
+    using Result = ClipboardCopier::Result;
+
+    void copyRows(QPromise<Result>& promise, TableTextFormat::Job job, qint64 maxBytes)
+    {
+        promise.setProgressRange(0, 100);
+        const int rowCount = TableTextFormat::rowCount(job);
+
+        std::vector<int> chunks;
+        for (int first = 0; first < rowCount; first += TableTextFormat::kChunkRows)
+            chunks.push_back(first);
+        const size_t batchChunks = static_cast<size_t>(std::max(2, QThreadPool::globalInstance()->maxThreadCount() * 2));
+
+        Result result;
+        const std::string header = TableTextFormat::formatHeader(job);
+        result.text.append(header.data(), static_cast<qsizetype>(header.size()));
+
+        // Batches bound the work lost to a cancel and let the size guard stop before the whole selection is formatted.
+        for (size_t batch = 0; batch < chunks.size(); batch += batchChunks) {
+            const auto begin = chunks.begin() + batch;
+            const auto end = chunks.begin() + std::min(chunks.size(), batch + batchChunks);
+            const auto parts = QtConcurrent::blockingMapped<QList<std::optional<std::string>>>(begin, end, [&job](int first) {
+                return TableTextFormat::formatChunk(job, first);
+            });
+            if (promise.isCanceled())
+                return;
+
+            for (const auto& part : parts) {
+                // Rows that could not be read fail the copy rather than leave a partial selection on the clipboard.
+                if (!part) {
+                    promise.addResult(Result{ QByteArray(), false, true });
+                    return;
+                }
+                if (result.text.size() + static_cast<qint64>(part->size()) > maxBytes) {
+                    promise.addResult(Result{ QByteArray(), true });
+                    return;
+                }
+                result.text.append(part->data(), static_cast<qsizetype>(part->size()));
+            }
+            promise.setProgressValue(static_cast<int>(100 * (end - chunks.begin()) / static_cast<qint64>(chunks.size())));
+        }
+
+        // No trailing line break, like a copy from a spreadsheet.
+        if (result.text.endsWith('\n'))
+            result.text.chop(1);
+        promise.addResult(std::move(result));
+    }
+}
+
+ClipboardCopier::ClipboardCopier(QObject* parent)
+    : QObject(parent)
+{
+    connect(&_watcher, &QFutureWatcherBase::progressValueChanged, this, &ClipboardCopier::progressChanged);
+    connect(&_watcher, &QFutureWatcherBase::finished, this, [this]() {
+        const bool canceled = _watcher.isCanceled() || _watcher.resultCount() == 0;
+        const Result result = canceled ? Result() : _watcher.result();
+        if (canceled || result.tooLarge || result.readFailed) {
+            emit finished(false, canceled, result.tooLarge);
+            return;
+        }
+
+        // Both formats share the one UTF-8 buffer; the clipboard converts on demand when another application pastes.
+        auto* mimeData = new QMimeData();
+        mimeData->setData(QStringLiteral("text/plain"), result.text);
+        mimeData->setData(_delimiter == '\t' ? QStringLiteral("text/tab-separated-values") : QStringLiteral("text/csv"), result.text);
+        QApplication::clipboard()->setMimeData(mimeData);
+        emit finished(true, false, false);
+    });
+}
+
+ClipboardCopier::~ClipboardCopier()
+{
+    cancel();
+    _watcher.waitForFinished();
+}
+
+bool ClipboardCopier::start(std::shared_ptr<const FastTableData> table, std::vector<int> rows, std::vector<int> columns, char delimiter)
+{
+    if (!table || rows.empty())
+        return false;
+    // A newer copy replaces the one in flight.
+    cancel();
+    _delimiter = delimiter;
+    _watcher.setFuture(QtConcurrent::run(copyRows, TableTextFormat::Job{ std::move(table), std::move(rows), std::move(columns), delimiter }, _maxBytes));
+    return true;
+}
+
+void ClipboardCopier::cancel()
+{
+    if (_watcher.isRunning())
+        _watcher.cancel();
+}
+
+void ClipboardCopier::cancelAndWait()
+{
+    cancel();
+    _watcher.waitForFinished();
+}
+
+bool ClipboardCopier::isBusy() const
+{
+    return _watcher.isRunning();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QFutureWatcher>
+#include <memory>
+#include <vector>
+#include "FastTableData.h"
+
+// Copies table rows to the clipboard without blocking the GUI thread. Rows are formatted in parallel chunks on worker
+// threads into one UTF-8 buffer, which is offered as plain text and as a text/tab-separated-values (or text/csv) payload.
+// Copies that would exceed the size limit, or whose rows cannot be read, stop early and leave the clipboard untouched.
+class ClipboardCopier : public QObject {
+    Q_OBJECT
+public:
+    explicit ClipboardCopier(QObject* parent = nullptr);
+    ~ClipboardCopier() override;
+
+    // rows and columns in order, columns empty for all; paged tables take source rows, others table rows.
+    bool start(std::shared_ptr<const FastTableData> table, std::vector<int> rows, std::vector<int> columns = {}, char delimiter = '\t');
+    void cancel();
+    // Cancels and waits until the copy no longer reads the table.
+    void cancelAndWait();
+    bool isBusy() const;
+
+    void setMaxBytes(qint64 maxBytes) { _maxBytes = maxBytes; }
+    qint64 maxBytes() const { return _maxBytes; }
+
+    struct Result {
+        QByteArray text;
+        bool tooLarge = false;
+        bool readFailed = false;
+    };
+
+signals:
+    void progressChanged(int percent);
+    void finished(bool success, bool canceled, bool tooLarge);
+
+private:
+    QFutureWatcher<Result> _watcher;
+    qint64 _maxBytes = 256LL * 1024 * 1024;
+    char _delimiter = '\t';
+};
@@ -0,0 +1,33 @@
+#include "ClusterCodes.h"
+#include <cstdint>
+
+const QString& ClusterCodes::label(int row) const
+{
+    static const QString unlabeled;
+    const auto code = codes[row];
+    return code >= 0 ? labels[code] : unlabeled;
+}
+
+ClusterCodes ClusterCodes::fromClusters(const mv::Dataset<Clusters>& clusters, int rows)
+{
+    ClusterCodes result;
+    result.codes.assign(rows, -1);
+
+    const auto& clusterList = clusters->getClusters();
+    result.labels.reserve(clusterList.size());
+    for (const auto& cluster : clusterList) {
+        const auto clusterName = cluster.getName();
+        result.labels.push_back(clusterName);
+        if (!clusterName.isEmpty() && cluster.getColor().isValid() && result.colors.find(clusterName) == result.colors.end())
+            result.colors[clusterName] = cluster.getColor();
+    }
+
+    // A point in several clusters keeps the last one. One pass over all indices, so a plain scatter in cluster order.
+    for (size_t code = 0; code < clusterList.size(); ++code) {
+        for (const auto& index : clusterList[code].getIndices()) {
+            if (static_cast<int>(index) < rows)
+                result.codes[index] = static_cast<std::int32_t>(code);
+        }
+    }
+    return result;
+}
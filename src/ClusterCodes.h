@@ -0,0 +1,21 @@
+#pragma once
+
+#include <Dataset.h>
+#include <ClusterData/ClusterData.h>
+#include <QString>
+#include <QColor>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// Dictionary-encoded label column of a Clusters dataset: one code per point into labels, -1 for points in no cluster.
+struct ClusterCodes {
+    std::vector<QString> labels;
+    std::vector<std::int32_t> codes;
+    std::map<QString, QColor> colors;
+
+    const QString& label(int row) const;
+
+    // Scatters the cluster indices into the code array in parallel across clusters, one O(points) pass.
+    static ClusterCodes fromClusters(const mv::Dataset<Clusters>& clusters, int rows);
+};
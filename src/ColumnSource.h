@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QString>
+#include <QColor>
+#include <map>
+#include <vector>
+#include "FastTableData.h"
+
+// Supplies whole columns on demand to a FastTableData, so only the columns in use are materialized.
+class ColumnSource {
+public:
+    virtual ~ColumnSource() = default;
+
+    virtual int rowCount() const = 0;
+    virtual int colCount() const = 0;
+
+    virtual QString columnName(int col) const = 0;
+    virtual bool columnIsNumeric(int col) const = 0;
+
+    // Label -> background color for categorical columns, empty when the column has no color map.
+    virtual std::map<QString, QColor> columnLabelColors(int col) const { return {}; }
+
+    // Range of a numeric column when the source knows it without reading the column.
+    virtual bool columnRange(int col, double& minVal, double& maxVal) const { return false; }
+
+    // Reads column col into out, one value per row. Called from worker threads, possibly for several columns at once.
+    virtual bool readColumn(int col, std::vector<FastTableData::Value>& out) const = 0;
+
+    // Reads numeric column col in its native element type; false when the source cannot, readColumn is used then.
+    virtual bool readNumericColumn(int col, NumericBuffer& out) const { return false; }
+
+    // Reads only the given rows of column col, in that order; false when the source cannot.
+    virtual bool readColumnRows(int col, const std::vector<int>& rows, std::vector<FastTableData::Value>& out) const { return false; }
+};
@@ -2,6 +2,12 @@
 #include "FastTableData.h"
 #include <QAbstractItemModel>
 
+namespace {
+    // Below this size number cells skip their text in fast mode.
+    constexpr int kFastModeMinTextWidth = 48;
+    constexpr int kFastModeMinTextHeight = 14;
+}
+
 void CorrelationBarDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
     const QModelIndex& index) const
 {
@@ -23,7 +29,7 @@ void CorrelationBarDelegate::paint(QPainter* painter, const QStyleOptionViewItem
             filledRect.setRight(barEndX);
 
             painter->save();
-            painter->setRenderHint(QPainter::Antialiasing, true);
+            painter->setRenderHint(QPainter::Antialiasing, !_fastMode);
 
             QColor bgColor = (option.state & QStyle::State_Selected)
                 ? option.palette.color(QPalette::Highlight)
@@ -41,8 +47,8 @@ void CorrelationBarDelegate::paint(QPainter* painter, const QStyleOptionViewItem
             QColor axisColor = isDarkMode ? QColor(Qt::white) : QColor(Qt::black);
 
             QPen axisPen(axisColor);
-            axisPen.setWidth(2);
-            axisPen.setStyle(Qt::DotLine);
+            axisPen.setWidth(_fastMode ? 1 : 2);
+            axisPen.setStyle(_fastMode ? Qt::SolidLine : Qt::DotLine);
 
             int axisExtra = std::max(2, barRect.height() / 8);
             int axisTop = barRect.top() - axisExtra;
@@ -57,7 +63,7 @@ void CorrelationBarDelegate::paint(QPainter* painter, const QStyleOptionViewItem
                 painter->drawRect(filledRect.normalized());
             }
 
-            if (option.state & QStyle::State_HasFocus) {
+            if (!_fastMode && (option.state & QStyle::State_HasFocus)) {
                 QStyleOptionFocusRect focusOption;
                 focusOption.QStyleOption::operator=(option);
                 focusOption.rect = option.rect;
@@ -77,9 +83,12 @@ void CorrelationBarDelegate::paint(QPainter* painter, const QStyleOptionViewItem
 
             painter->save();
             painter->fillRect(option.rect, bgColor);
-            painter->setPen(textColor);
-            QString valueText = QString::number(value, 'g', 4);
-            painter->drawText(option.rect.adjusted(4, 4, -4, -4), Qt::AlignCenter, valueText);
+            const bool skipText = _fastMode && (option.rect.width() < kFastModeMinTextWidth || option.rect.height() < kFastModeMinTextHeight);
+            if (!skipText) {
+                painter->setPen(textColor);
+                QString valueText = QString::number(value, 'g', 4);
+                painter->drawText(option.rect.adjusted(4, 4, -4, -4), Qt::AlignCenter, valueText);
+            }
             painter->restore();
         }
     }
@@ -40,6 +40,10 @@ public:
     void setDisplayMode(DisplayMode mode) { _displayMode = mode; }
     DisplayMode displayMode() const { return _displayMode; }
 
+    // Cheap rendering while the view scrolls fast: solid bars, no antialiasing, no text in small cells.
+    void setFastMode(bool fast) { _fastMode = fast; }
+    bool fastMode() const { return _fastMode; }
+
     void paint(QPainter* painter, const QStyleOptionViewItem& option,
         const QModelIndex& index) const override;
 
@@ -49,6 +53,7 @@ public:
 private:
     float minValue, maxValue;
     DisplayMode _displayMode;
+    bool _fastMode = false;
 
     bool isColorContrastive(const QColor& c1, const QColor& c2) const;
 };
\ No newline at end of file
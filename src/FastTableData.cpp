@@ -5,71 +5,154 @@
 #include <QVariantMap>
 #include <QVariantList>
 #include <algorithm>
+#include <numeric>
 #include "TableDataUtils.h"
+#include "RowSource.h"
+#include "CachedRowSource.h"
+#include "ColumnSource.h"
+#include <QtConcurrent>
 #include <QColor>
 #include <optional>
+#include <type_traits>
 
 FastTableData::FastTableData(int rows, int cols) {
     resize(rows, cols);
-    m_cellColors.resize(rows, std::vector<std::optional<QColor>>(cols));
-    m_cellTextColors.resize(rows, std::vector<std::optional<QColor>>(cols));
 }
 
 void FastTableData::resize(int rows, int cols) {
     _rows = rows;
     _cols = cols;
-    _data.resize(rows * cols);
-    _colNames.resize(cols);
-    _colIsNumeric.assign(cols, true);
-    _colMinMax.resize(cols, {0.0, 0.0});
+    _columns.resize(cols);
+    for (auto& column : _columns) {
+        if (!column)
+            column = std::make_shared<Column>();
+    }
+    for (int c = 0; c < cols; ++c) {
+        auto& column = mutableColumn(c);
+        column.isNumeric = true;
+        column.values.resize(rows);
+        column.cellColors.resize(rows);
+        column.cellTextColors.resize(rows);
+    }
     _rowBarColors.resize(rows);
     _rowVisible.assign(rows, true);
-    m_cellColors.resize(rows, std::vector<std::optional<QColor>>(cols));
-    m_cellTextColors.resize(rows, std::vector<std::optional<QColor>>(cols));
+    _columnLastUse.resize(cols, 0);
+    rebuildColumnIndex();
+}
+
+FastTableData::Column& FastTableData::mutableColumn(int col) {
+    auto& column = _columns[col];
+    if (column.use_count() > 1)
+        column = std::make_shared<Column>(*column);
+    return *column;
+}
+
+void FastTableData::rebuildColumnIndex() {
+    _columnIndex.clear();
+    _columnIndex.reserve(_cols);
+    for (int c = _cols - 1; c >= 0; --c)
+        _columnIndex.insert(_columns[c]->name, c);
+}
+
+namespace {
+    double toDouble(const FastTableData::Value& v) {
+        if (std::holds_alternative<double>(v)) return std::get<double>(v);
+        if (std::holds_alternative<int>(v)) return static_cast<double>(std::get<int>(v));
+        return 0.0;
+    }
+
+    // Reorders items so that new position r holds old position order[r]; per-row vectors that are not filled stay as they are.
+    template <typename Items>
+    void permuteItems(Items& items, const std::vector<int>& order) {
+        if (items.size() != order.size())
+            return;
+        Items permuted(items.size());
+        for (size_t r = 0; r < order.size(); ++r)
+            permuted[r] = std::move(items[order[r]]);
+        items = std::move(permuted);
+    }
 }
 
 void FastTableData::set(int row, int col, const Value& v) {
     assert(row >= 0 && row < _rows && col >= 0 && col < _cols);
-    _data[row * _cols + col] = v;
+    if (!isColumnResident(col))
+        return;
+    auto& column = mutableColumn(col);
+    if (!column.typed) {
+        column.values[row] = v;
+        return;
+    }
+    std::visit([&](auto& values) {
+        using T = typename std::decay_t<decltype(values)>::value_type;
+        if constexpr (std::is_same_v<T, BFloat16>)
+            values[row] = BFloat16::fromFloat(static_cast<float>(toDouble(v)));
+        else
+            values[row] = static_cast<T>(toDouble(v));
+    }, column.numeric);
 }
 
-const FastTableData::Value& FastTableData::get(int row, int col) const {
+FastTableData::Value FastTableData::get(int row, int col) const {
     assert(row >= 0 && row < _rows && col >= 0 && col < _cols);
-    return _data[row * _cols + col];
+    // Columns that are not materialized read as empty cells.
+    if (!isColumnResident(col))
+        return QString();
+    const auto& column = *_columns[col];
+    if (!column.typed)
+        return column.values[row];
+    return std::visit([row](const auto& values) -> Value {
+        using T = typename std::decay_t<decltype(values)>::value_type;
+        if constexpr (std::is_integral_v<T>)
+            return static_cast<int>(values[row]);
+        else
+            return static_cast<double>(values[row]);
+    }, column.numeric);
 }
 
 void FastTableData::setColumnName(int col, const QString& name) {
-    if (col >= 0 && col < _cols) _colNames[col] = name;
+    if (col >= 0 && col < _cols) {
+        mutableColumn(col).name = name;
+        rebuildColumnIndex();
+    }
 }
 
 QString FastTableData::columnName(int col) const {
-    if (col >= 0 && col < _cols) return _colNames[col];
+    if (col >= 0 && col < _cols) return _columns[col]->name;
     return {};
 }
 
+int FastTableData::columnIndex(const QString& name) const {
+    return _columnIndex.value(name, -1);
+}
+
 void FastTableData::setColumnIsNumeric(int col, bool isNumeric) {
-    if (col >= 0 && col < _cols) _colIsNumeric[col] = isNumeric;
+    if (col >= 0 && col < _cols) mutableColumn(col).isNumeric = isNumeric;
 }
 
 bool FastTableData::columnIsNumeric(int col) const {
-    if (col >= 0 && col < _cols) return _colIsNumeric[col];
+    if (col >= 0 && col < _cols) return _columns[col]->isNumeric;
     return true;
 }
 
 void FastTableData::setColumnMinMax(int col, double minVal, double maxVal) {
-    if (col >= 0 && col < _cols) _colMinMax[col] = {minVal, maxVal};
+    if (col >= 0 && col < _cols) mutableColumn(col).minMax = {minVal, maxVal};
 }
 
 void FastTableData::getColumnMinMax(int col, double& minVal, double& maxVal) const {
     if (col >= 0 && col < _cols) {
-        minVal = _colMinMax[col].first;
-        maxVal = _colMinMax[col].second;
+        minVal = _columns[col]->minMax.first;
+        maxVal = _columns[col]->minMax.second;
     } else {
         minVal = 0.0;
         maxVal = 0.0;
     }
 }
 
+std::map<QString, QColor> FastTableData::columnLabelColors(int col) const {
+    if (col >= 0 && col < _cols)
+        return _columns[col]->labelColors;
+    return {};
+}
+
 int FastTableData::primaryKeyColumn() const {
     return _primaryKeyCol;
 }
@@ -95,8 +178,10 @@ std::vector<FastTableData::Value> FastTableData::getRow(int row) const {
 }
 
 std::vector<FastTableData::Value> FastTableData::getColumn(int col) const {
+    if (col < 0 || col >= _cols) return {};
+    if (!_columns[col]->typed)
+        return _columns[col]->values;
     std::vector<Value> result;
-    if (col < 0 || col >= _cols) return result;
     result.reserve(_rows);
     for (int r = 0; r < _rows; ++r)
         result.push_back(get(r, col));
@@ -119,6 +204,109 @@ std::vector<std::vector<FastTableData::Value>> FastTableData::getColumns() const
     return result;
 }
 
+void FastTableData::permuteRows(const std::vector<int>& order) {
+    assert(static_cast<int>(order.size()) == _rows);
+    for (int c = 0; c < _cols; ++c) {
+        if (isColumnResident(c))
+            permuteColumn(mutableColumn(c), order);
+    }
+    permuteItems(_rowBarColors, order);
+    // Lazy columns read later and replaced columns are put in the same order.
+    if (_sourceRowOf.empty()) {
+        _sourceRowOf.resize(_rows);
+        std::iota(_sourceRowOf.begin(), _sourceRowOf.end(), 0);
+    }
+    permuteItems(_sourceRowOf, order);
+    std::vector<bool> rowVisible(_rows);
+    for (int r = 0; r < _rows; ++r)
+        rowVisible[r] = _rowVisible[order[r]];
+    _rowVisible = std::move(rowVisible);
+}
+
+void FastTableData::permuteColumn(Column& column, const std::vector<int>& order) {
+    // Typed columns have no per-cell colors, they are colored from their values.
+    if (column.typed) {
+        std::visit([&order](auto& values) { permuteItems(values, order); }, column.numeric);
+        return;
+    }
+    permuteItems(column.values, order);
+    permuteItems(column.cellColors, order);
+    permuteItems(column.cellTextColors, order);
+}
+
+std::vector<int> FastTableData::sortedRowOrder(int col, bool ascending) const {
+    std::vector<int> order(_rows);
+    std::iota(order.begin(), order.end(), 0);
+    if (col < 0 || col >= _cols)
+        return order;
+
+    const auto& column = *_columns[col];
+    if (column.typed) {
+        std::visit([&](const auto& values) { NumericKernels::sortRows(order, values, ascending); }, column.numeric);
+        return order;
+    }
+
+    auto valueLess = [&column](int a, int b) {
+        const auto& va = column.values[a];
+        const auto& vb = column.values[b];
+        if (std::holds_alternative<QString>(va) || std::holds_alternative<QString>(vb)) {
+            if (std::holds_alternative<QString>(va) && std::holds_alternative<QString>(vb))
+                return std::get<QString>(va) < std::get<QString>(vb);
+            return std::holds_alternative<QString>(vb);
+        }
+        return toDouble(va) < toDouble(vb);
+    };
+    if (ascending)
+        std::stable_sort(order.begin(), order.end(), valueLess);
+    else
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return valueLess(b, a); });
+    return order;
+}
+
+void FastTableData::appendRows(const FastTableData& block) {
+    assert(block.colCount() == _cols);
+    const int count = block.rowCount();
+    for (int c = 0; c < _cols; ++c) {
+        auto& column = mutableColumn(c);
+        const auto& from = *block._columns[c];
+        if (column.typed) {
+            assert(from.typed && from.numeric.index() == column.numeric.index());
+            std::visit([&from](auto& values) {
+                const auto& more = std::get<std::decay_t<decltype(values)>>(from.numeric);
+                values.insert(values.end(), more.begin(), more.end());
+            }, column.numeric);
+            continue;
+        }
+        column.values.insert(column.values.end(), from.values.begin(), from.values.end());
+        column.cellColors.insert(column.cellColors.end(), from.cellColors.begin(), from.cellColors.end());
+        column.cellTextColors.insert(column.cellTextColors.end(), from.cellTextColors.begin(), from.cellTextColors.end());
+    }
+    _rowBarColors.insert(_rowBarColors.end(), block._rowBarColors.begin(), block._rowBarColors.end());
+    _rowVisible.insert(_rowVisible.end(), block._rowVisible.begin(), block._rowVisible.end());
+    for (int r = 0; r < count && !_sourceRowOf.empty(); ++r)
+        _sourceRowOf.push_back(_rows + r);
+    _rows += count;
+}
+
+void FastTableData::replaceRows(int first, const FastTableData& block) {
+    assert(block.colCount() == _cols && first >= 0 && first + block.rowCount() <= _rows);
+    for (int c = 0; c < _cols; ++c) {
+        auto& column = mutableColumn(c);
+        const auto& from = *block._columns[c];
+        if (column.typed) {
+            assert(from.typed && from.numeric.index() == column.numeric.index());
+            std::visit([&from, first](auto& values) {
+                const auto& replacement = std::get<std::decay_t<decltype(values)>>(from.numeric);
+                std::copy(replacement.begin(), replacement.end(), values.begin() + first);
+            }, column.numeric);
+            continue;
+        }
+        std::copy(from.values.begin(), from.values.end(), column.values.begin() + first);
+        std::copy(from.cellColors.begin(), from.cellColors.end(), column.cellColors.begin() + first);
+        std::copy(from.cellTextColors.begin(), from.cellTextColors.end(), column.cellTextColors.begin() + first);
+    }
+}
+
 void FastTableData::setRowBarColor(int row, const QColor& color) {
     if (row >= 0 && row < _rows) _rowBarColors[row] = color;
 }
@@ -153,23 +341,36 @@ void FastTableData::clearRowFilter() {
 void FastTableData::clear() {
     _rows = 0;
     _cols = 0;
-    _data.clear();
-    _colNames.clear();
-    _colIsNumeric.clear();
-    _colMinMax.clear();
+    _columns.clear();
+    _columnIndex.clear();
     _rowBarColors.clear();
     _rowVisible.clear();
     _primaryKeyCol = -1;
-    m_cellColors.clear();
-    m_cellTextColors.clear();
+    _rowSource.reset();
+    _windowOffset = 0;
+    _windowCapacity = 0;
+    _columnSource.reset();
+    _residentCellBudget = 0;
+    _sourceRowOf.clear();
+    _columnLastUse.clear();
+}
+
+qint64 FastTableData::memoryUsage() const {
+    qint64 bytes = static_cast<qint64>(_rowBarColors.size() * sizeof(QColor) + _rowVisible.size() / 8
+        + _sourceRowOf.size() * sizeof(int));
+    for (const auto& column : _columns) {
+        bytes += static_cast<qint64>(column->values.size() * sizeof(Value) + NumericKernels::bytes(column->numeric)
+            + (column->cellColors.size() + column->cellTextColors.size()) * sizeof(std::optional<QColor>));
+    }
+    return bytes;
 }
 
 bool FastTableData::canFetchMoreRowsTop(int n) const {
-    return false;
+    return availableRowsTop() > 0;
 }
 
 bool FastTableData::canFetchMoreRowsBottom(int n) const {
-    return false;
+    return availableRowsBottom() > 0;
 }
 
 bool FastTableData::canFetchMoreColsLeft(int n) const {
@@ -181,9 +382,27 @@ bool FastTableData::canFetchMoreColsRight(int n) const {
 }
 
 void FastTableData::fetchMoreRowsTop(int n) {
+    const int count = std::min(n, availableRowsTop());
+    if (count <= 0)
+        return;
+    std::vector<Value> values;
+    if (!_rowSource->readRows(_windowOffset - count, count, values))
+        return;
+    insertRowBlock(0, values, count);
+    _windowOffset -= count;
+    colorRows(0, count);
 }
 
 void FastTableData::fetchMoreRowsBottom(int n) {
+    const int count = std::min(n, availableRowsBottom());
+    if (count <= 0)
+        return;
+    std::vector<Value> values;
+    if (!_rowSource->readRows(_windowOffset + _rows, count, values))
+        return;
+    const int first = _rows;
+    insertRowBlock(first, values, count);
+    colorRows(first, count);
 }
 
 void FastTableData::fetchMoreColsLeft(int n) {
@@ -192,71 +411,497 @@ void FastTableData::fetchMoreColsLeft(int n) {
 void FastTableData::fetchMoreColsRight(int n) {
 }
 
+void FastTableData::setRowSource(std::shared_ptr<RowSource> source, int windowRows) {
+    clear();
+    if (!source)
+        return;
+
+    const int cols = source->colCount();
+    resize(0, cols);
+    for (int c = 0; c < cols; ++c) {
+        auto& column = mutableColumn(c);
+        source->getColumnMinMax(c, column.minMax.first, column.minMax.second);
+        column.name = source->columnName(c);
+        column.isNumeric = source->columnIsNumeric(c);
+        if (!column.isNumeric)
+            column.labelColors = source->columnLabelColors(c);
+    }
+    rebuildColumnIndex();
+
+    // Reads go through a page cache, which the view's prefetcher warms ahead of scrolling.
+    _rowSource = std::dynamic_pointer_cast<CachedRowSource>(source);
+    if (!_rowSource)
+        _rowSource = std::make_shared<CachedRowSource>(std::move(source));
+    _windowCapacity = std::max(windowRows, 1);
+    _windowOffset = 0;
+    fetchMoreRowsBottom(_windowCapacity);
+}
+
+std::shared_ptr<CachedRowSource> FastTableData::rowCache() const {
+    return std::dynamic_pointer_cast<CachedRowSource>(_rowSource);
+}
+
+int FastTableData::sourceRowCount() const {
+    return _rowSource ? _rowSource->rowCount() : _rows;
+}
+
+int FastTableData::sourceRow(int row) const {
+    return _windowOffset + (_sourceRowOf.empty() ? row : _sourceRowOf[row]);
+}
+
+int FastTableData::availableRowsTop() const {
+    return _rowSource ? _windowOffset : 0;
+}
+
+int FastTableData::availableRowsBottom() const {
+    return _rowSource ? std::max(0, _rowSource->rowCount() - (_windowOffset + _rows)) : 0;
+}
+
+void FastTableData::evictRowsTop(int n) {
+    n = std::clamp(n, 0, _rows);
+    if (n == 0)
+        return;
+    for (int c = 0; c < _cols; ++c) {
+        auto& column = mutableColumn(c);
+        column.values.erase(column.values.begin(), column.values.begin() + n);
+        column.cellColors.erase(column.cellColors.begin(), column.cellColors.begin() + n);
+        column.cellTextColors.erase(column.cellTextColors.begin(), column.cellTextColors.begin() + n);
+    }
+    _rowBarColors.erase(_rowBarColors.begin(), _rowBarColors.begin() + n);
+    _rowVisible.erase(_rowVisible.begin(), _rowVisible.begin() + n);
+    _windowOffset += n;
+    _rows -= n;
+}
+
+void FastTableData::evictRowsBottom(int n) {
+    n = std::clamp(n, 0, _rows);
+    if (n == 0)
+        return;
+    const int keep = _rows - n;
+    for (int c = 0; c < _cols; ++c) {
+        auto& column = mutableColumn(c);
+        column.values.resize(keep);
+        column.cellColors.resize(keep);
+        column.cellTextColors.resize(keep);
+    }
+    _rowBarColors.resize(keep);
+    _rowVisible.resize(keep);
+    _rows = keep;
+}
+
+void FastTableData::repositionWindow(int firstSourceRow) {
+    assert(_rows == 0);
+    if (_rowSource)
+        _windowOffset = std::clamp(firstSourceRow, 0, _rowSource->rowCount());
+}
+
+void FastTableData::insertRowBlock(int at, const std::vector<Value>& values, int count) {
+    // values is row-major as delivered by the RowSource.
+    for (int c = 0; c < _cols; ++c) {
+        auto& column = mutableColumn(c);
+        column.values.insert(column.values.begin() + at, count, Value{});
+        for (int r = 0; r < count; ++r)
+            column.values[at + r] = values[static_cast<size_t>(r) * _cols + c];
+        column.cellColors.insert(column.cellColors.begin() + at, count, std::nullopt);
+        column.cellTextColors.insert(column.cellTextColors.begin() + at, count, std::nullopt);
+    }
+    _rowBarColors.insert(_rowBarColors.begin() + at, count, QColor());
+    _rowVisible.insert(_rowVisible.begin() + at, count, true);
+    _rows += count;
+}
+
+void FastTableData::colorRows(int first, int count) {
+    for (int c = 0; c < _cols; ++c) {
+        if (!_columns[c]->typed)
+            colorColumn(mutableColumn(c), first, count);
+    }
+}
+
+void FastTableData::colorColumn(Column& column, int first, int count) {
+    if (column.isNumeric) {
+        const auto [minVal, maxVal] = column.minMax;
+        for (int r = first; r < first + count; ++r) {
+            const auto& v = column.values[r];
+            const double value = std::holds_alternative<double>(v) ? std::get<double>(v)
+                : std::holds_alternative<int>(v) ? static_cast<double>(std::get<int>(v)) : 0.0;
+            const QColor bg = getNumericCellColor(value, minVal, maxVal);
+            column.cellColors[r] = bg;
+            column.cellTextColors[r] = getContrastingTextColor(bg);
+        }
+    } else {
+        const auto& labelColors = column.labelColors;
+        for (int r = first; r < first + count; ++r) {
+            const auto& v = column.values[r];
+            auto it = std::holds_alternative<QString>(v) ? labelColors.find(std::get<QString>(v)) : labelColors.end();
+            if (it != labelColors.end()) {
+                column.cellColors[r] = it->second;
+                column.cellTextColors[r] = getContrastingTextColor(it->second);
+            } else {
+                column.cellTextColors[r] = getContrastingTextColor(QColor());
+            }
+        }
+    }
+}
+
+void FastTableData::setColumnSource(std::shared_ptr<ColumnSource> source, qint64 residentCellBudget) {
+    clear();
+    if (!source)
+        return;
+
+    resize(source->rowCount(), 0);
+    for (int c = 0; c < source->colCount(); ++c) {
+        auto column = std::make_shared<Column>();
+        column->name = source->columnName(c);
+        column->isNumeric = source->columnIsNumeric(c);
+        if (!column->isNumeric)
+            column->labelColors = source->columnLabelColors(c);
+        // Stored ranges let bars and colors be right before the column is read.
+        if (column->isNumeric)
+            source->columnRange(c, column->minMax.first, column->minMax.second);
+        column->sourceColumn = c;
+        _columns.push_back(std::move(column));
+    }
+    _cols = static_cast<int>(_columns.size());
+    _columnLastUse.assign(_cols, 0);
+    rebuildColumnIndex();
+    _columnSource = std::move(source);
+    _residentCellBudget = residentCellBudget;
+}
+
+bool FastTableData::isColumnResident(int col) const {
+    if (col < 0 || col >= _cols)
+        return false;
+    const auto& column = *_columns[col];
+    const size_t size = column.typed ? NumericKernels::size(column.numeric) : column.values.size();
+    return column.sourceColumn < 0 || static_cast<int>(size) == _rows;
+}
+
+std::vector<int> FastTableData::missingColumns(int first, int last) {
+    std::vector<int> missing;
+    if (!_columnSource)
+        return missing;
+    first = std::max(first, 0);
+    last = std::min(last, _cols - 1);
+    for (int c = first; c <= last; ++c) {
+        _columnLastUse[c] = ++_useClock;
+        if (!isColumnResident(c))
+            missing.push_back(c);
+    }
+    return missing;
+}
+
+FastTableData::LoadedColumns FastTableData::loadColumns(const std::vector<int>& cols) const {
+    LoadedColumns loaded;
+    loaded.source = _columnSource;
+    if (!_columnSource)
+        return loaded;
+    for (int c : cols) {
+        if (c >= 0 && c < _cols && _columns[c]->sourceColumn >= 0)
+            loaded.columns.push_back(c);
+    }
+
+    // Read, measure and color the columns in parallel; ordering them by the current sort is left to adoptColumns.
+    loaded.data.resize(loaded.columns.size());
+    std::vector<int> slots(loaded.columns.size());
+    std::iota(slots.begin(), slots.end(), 0);
+    QtConcurrent::blockingMap(slots, [&](int slot) {
+        auto column = std::make_shared<Column>(*_columns[loaded.columns[slot]]);
+
+        // Sources that can hand out native numeric buffers keep their element type.
+        NumericBuffer numeric;
+        if (column->isNumeric && _columnSource->readNumericColumn(column->sourceColumn, numeric)
+            && static_cast<int>(NumericKernels::size(numeric)) == _rows) {
+            column->minMax = std::visit([](const auto& native) { return NumericKernels::range(native); }, numeric);
+            column->typed = true;
+            column->numeric = std::move(numeric);
+            loaded.data[slot] = std::move(column);
+            return;
+        }
+
+        if (!_columnSource->readColumn(column->sourceColumn, column->values) || static_cast<int>(column->values.size()) != _rows)
+            return;
+        if (column->isNumeric && _rows > 0) {
+            double minVal = std::numeric_limits<double>::max();
+            double maxVal = std::numeric_limits<double>::lowest();
+            for (const auto& v : column->values) {
+                const double value = std::holds_alternative<double>(v) ? std::get<double>(v)
+                    : std::holds_alternative<int>(v) ? static_cast<double>(std::get<int>(v)) : 0.0;
+                minVal = std::min(minVal, value);
+                maxVal = std::max(maxVal, value);
+            }
+            column->minMax = { minVal, maxVal };
+        }
+        column->cellColors.resize(_rows);
+        column->cellTextColors.resize(_rows);
+        colorColumn(*column, 0, _rows);
+        loaded.data[slot] = std::move(column);
+    });
+    return loaded;
+}
+
+std::vector<int> FastTableData::adoptColumns(LoadedColumns loaded, int first, int last) {
+    std::vector<int> changed;
+    // Columns read for a table that was replaced since, or that were moved or loaded meanwhile, are dropped.
+    if (!_columnSource || loaded.source != _columnSource)
+        return changed;
+    for (size_t i = 0; i < loaded.columns.size(); ++i) {
+        const int c = loaded.columns[i];
+        auto& column = loaded.data[i];
+        if (!column || c >= _cols || _columns[c]->sourceColumn != column->sourceColumn || isColumnResident(c))
+            continue;
+        // The column is in source order, a sorted table holds its rows in _sourceRowOf order.
+        if (!_sourceRowOf.empty())
+            permuteColumn(*column, _sourceRowOf);
+        _columns[c] = std::move(column);
+        changed.push_back(c);
+    }
+
+    if (_residentCellBudget <= 0 || _rows == 0)
+        return changed;
+
+    // Evict the least recently used lazy columns outside [first, last] until the budget holds.
+    std::vector<int> resident;
+    for (int c = 0; c < _cols; ++c) {
+        if (_columns[c]->sourceColumn >= 0 && isColumnResident(c))
+            resident.push_back(c);
+    }
+    std::sort(resident.begin(), resident.end(), [this](int a, int b) { return _columnLastUse[a] < _columnLastUse[b]; });
+    qint64 cells = static_cast<qint64>(resident.size()) * _rows;
+    for (int c : resident) {
+        if (cells <= _residentCellBudget)
+            break;
+        if (c >= first && c <= last)
+            continue;
+        auto column = std::make_shared<Column>();
+        column->name = _columns[c]->name;
+        column->isNumeric = _columns[c]->isNumeric;
+        column->labelColors = _columns[c]->labelColors;
+        column->sourceColumn = _columns[c]->sourceColumn;
+        column->origin = _columns[c]->origin;
+        _columns[c] = std::move(column);
+        cells -= _rows;
+        changed.push_back(c);
+    }
+    return changed;
+}
+
 void FastTableData::addColumn(const QString& name, const Value& defaultValue) {
-    _colNames.push_back(name);
-    _colIsNumeric.push_back(std::holds_alternative<double>(defaultValue) || std::holds_alternative<int>(defaultValue));
-    _colMinMax.emplace_back(0.0, 0.0);
-    _cols += 1;
-    for (int row = 0; row < _rows; ++row) {
-        _data.insert(_data.begin() + row * _cols + (_cols - 1), defaultValue);
-        m_cellColors[row].insert(m_cellColors[row].begin() + (_cols - 1), std::nullopt);
-        m_cellTextColors[row].insert(m_cellTextColors[row].begin() + (_cols - 1), std::nullopt);
+    addColumns({ { name, defaultValue } });
+}
+
+void FastTableData::addColumns(const std::vector<std::pair<QString, Value>>& columns) {
+    if (columns.empty())
+        return;
+
+    // Appending a column allocates its own buffer, the existing ones are left untouched.
+    for (const auto& [name, defaultValue] : columns) {
+        auto column = std::make_shared<Column>();
+        column->name = name;
+        column->isNumeric = std::holds_alternative<double>(defaultValue) || std::holds_alternative<int>(defaultValue);
+        column->values.assign(_rows, defaultValue);
+        column->cellColors.resize(_rows);
+        column->cellTextColors.resize(_rows);
+        if (!_columnIndex.contains(name))
+            _columnIndex.insert(name, _cols);
+        _columns.push_back(std::move(column));
+        _columnLastUse.push_back(0);
+        ++_cols;
     }
 }
 
+void FastTableData::appendNumericColumn(const QString& name, NumericBuffer values) {
+    assert(static_cast<int>(NumericKernels::size(values)) == _rows);
+    auto column = std::make_shared<Column>();
+    column->name = name;
+    column->isNumeric = true;
+    column->typed = true;
+    column->minMax = std::visit([](const auto& native) { return NumericKernels::range(native); }, values);
+    column->numeric = std::move(values);
+
+    if (!_columnIndex.contains(name))
+        _columnIndex.insert(name, _cols);
+    _columns.push_back(std::move(column));
+    _columnLastUse.push_back(0);
+    ++_cols;
+}
+
+bool FastTableData::isTypedColumn(int col) const {
+    return col >= 0 && col < _cols && _columns[col]->typed;
+}
+
+const NumericBuffer* FastTableData::numericColumn(int col) const {
+    if (col >= 0 && col < _cols && _columns[col]->typed && isColumnResident(col))
+        return &_columns[col]->numeric;
+    return nullptr;
+}
+
+bool FastTableData::readCells(int col, const std::vector<int>& rows, std::vector<Value>& out) const {
+    if (col < 0 || col >= _cols)
+        return false;
+    out.resize(rows.size());
+    if (isColumnResident(col)) {
+        for (size_t i = 0; i < rows.size(); ++i)
+            out[i] = get(rows[i], col);
+        return true;
+    }
+
+    std::vector<int> sourceRows(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i)
+        sourceRows[i] = _sourceRowOf.empty() ? rows[i] : _sourceRowOf[rows[i]];
+    return _columnSource->readColumnRows(_columns[col]->sourceColumn, sourceRows, out);
+}
+
+void FastTableData::setColumnOrigin(int col, const QString& datasetId) {
+    if (col >= 0 && col < _cols)
+        mutableColumn(col).origin = datasetId;
+}
+
+QString FastTableData::columnOrigin(int col) const {
+    if (col >= 0 && col < _cols)
+        return _columns[col]->origin;
+    return {};
+}
+
+std::vector<int> FastTableData::replaceColumns(const FastTableData& block) {
+    if (block.rowCount() != _rows || _rowSource || _columnSource)
+        return {};
+
+    // Columns are matched by origin, in order; any mismatch leaves the table untouched.
+    QHash<QString, std::vector<int>> ownColumns, blockColumns;
+    for (int c = 0; c < _cols; ++c) {
+        if (!_columns[c]->origin.isEmpty())
+            ownColumns[_columns[c]->origin].push_back(c);
+    }
+    for (int c = 0; c < block.colCount(); ++c) {
+        if (block._columns[c]->origin.isEmpty())
+            return {};
+        blockColumns[block._columns[c]->origin].push_back(c);
+    }
+    for (auto it = blockColumns.cbegin(); it != blockColumns.cend(); ++it) {
+        if (ownColumns.value(it.key()).size() != it.value().size())
+            return {};
+    }
+
+    std::vector<int> replaced;
+    for (auto it = blockColumns.cbegin(); it != blockColumns.cend(); ++it) {
+        const auto& own = ownColumns[it.key()];
+        for (size_t i = 0; i < own.size(); ++i) {
+            auto column = block._columns[it.value()[i]];
+            // The block is in source order, a sorted table holds its rows in _sourceRowOf order.
+            if (!_sourceRowOf.empty()) {
+                column = std::make_shared<Column>(*column);
+                permuteColumn(*column, _sourceRowOf);
+            }
+            _columns[own[i]] = std::move(column);
+            replaced.push_back(own[i]);
+        }
+    }
+    rebuildColumnIndex();
+    std::sort(replaced.begin(), replaced.end());
+    return replaced;
+}
+
+void FastTableData::appendColumn(const QString& name, std::vector<Value> values, bool isNumeric, const std::map<QString, QColor>& labelColors) {
+    assert(static_cast<int>(values.size()) == _rows);
+    auto column = std::make_shared<Column>();
+    column->name = name;
+    column->isNumeric = isNumeric;
+    column->labelColors = labelColors;
+    column->values = std::move(values);
+    if (isNumeric && _rows > 0) {
+        double minVal = std::numeric_limits<double>::max();
+        double maxVal = std::numeric_limits<double>::lowest();
+        for (const auto& v : column->values) {
+            const double value = std::holds_alternative<double>(v) ? std::get<double>(v)
+                : std::holds_alternative<int>(v) ? static_cast<double>(std::get<int>(v)) : 0.0;
+            minVal = std::min(minVal, value);
+            maxVal = std::max(maxVal, value);
+        }
+        column->minMax = { minVal, maxVal };
+    }
+    column->cellColors.resize(_rows);
+    column->cellTextColors.resize(_rows);
+    colorColumn(*column, 0, _rows);
+
+    if (!_columnIndex.contains(name))
+        _columnIndex.insert(name, _cols);
+    _columns.push_back(std::move(column));
+    _columnLastUse.push_back(0);
+    ++_cols;
+}
+
+void FastTableData::removeColumns(std::vector<int> cols) {
+    std::sort(cols.begin(), cols.end());
+    cols.erase(std::unique(cols.begin(), cols.end()), cols.end());
+    cols.erase(std::remove_if(cols.begin(), cols.end(), [this](int col) { return col < 0 || col >= _cols; }), cols.end());
+    if (cols.empty())
+        return;
+
+    // Dropping columns only moves the column handles behind the first removed one; the cell buffers are released with them.
+    int removed = 0;
+    int newPrimaryKey = _primaryKeyCol;
+    for (int c = cols.front(), write = cols.front(); c < _cols; ++c) {
+        if (removed < static_cast<int>(cols.size()) && cols[removed] == c) {
+            if (c == _primaryKeyCol)
+                newPrimaryKey = -1;
+            ++removed;
+            continue;
+        }
+        if (c == _primaryKeyCol)
+            newPrimaryKey = write;
+        _columnLastUse[write] = _columnLastUse[c];
+        _columns[write++] = std::move(_columns[c]);
+    }
+    _cols -= removed;
+    _columns.resize(_cols);
+    _columnLastUse.resize(_cols);
+    _primaryKeyCol = newPrimaryKey;
+    rebuildColumnIndex();
+}
+
 bool FastTableData::removeColumn(const QString& name) {
-    auto it = std::find(_colNames.begin(), _colNames.end(), name);
-    if (it == _colNames.end())
+    return removeColumnAt(columnIndex(name));
+}
+
+bool FastTableData::removeColumnAt(int col) {
+    if (col < 0 || col >= _cols)
         return false;
-    int col = std::distance(_colNames.begin(), it);
-    for (int row = _rows - 1; row >= 0; --row) {
-        _data.erase(_data.begin() + row * _cols + col);
-        m_cellColors[row].erase(m_cellColors[row].begin() + col);
-        m_cellTextColors[row].erase(m_cellTextColors[row].begin() + col);
-    }
-    _colNames.erase(_colNames.begin() + col);
-    _colIsNumeric.erase(_colIsNumeric.begin() + col);
-    _colMinMax.erase(_colMinMax.begin() + col);
-    if (_primaryKeyCol == col) _primaryKeyCol = -1;
-    else if (_primaryKeyCol > col) _primaryKeyCol--;
-    _cols -= 1;
+    removeColumns({ col });
     return true;
 }
 
 void FastTableData::setCellColor(int row, int col, const QColor& color) {
-    if (row >= 0 && row < static_cast<int>(m_cellColors.size()) &&
-        col >= 0 && col < static_cast<int>(m_cellColors[row].size())) {
-        m_cellColors[row][col] = color;
-    }
+    if (row >= 0 && row < _rows && isColumnResident(col) && !_columns[col]->typed)
+        mutableColumn(col).cellColors[row] = color;
 }
 
 QColor FastTableData::cellColor(int row, int col) const {
-    if (row >= 0 && row < static_cast<int>(m_cellColors.size()) &&
-        col >= 0 && col < static_cast<int>(m_cellColors[row].size()) &&
-        m_cellColors[row][col].has_value()) {
-        return m_cellColors[row][col].value();
-    }
+    if (row < 0 || row >= _rows || !isColumnResident(col))
+        return QColor();
+    const auto& column = *_columns[col];
+    // Typed columns derive their colors from the value and the column range instead of storing them.
+    if (column.typed)
+        return getNumericCellColor(toDouble(get(row, col)), column.minMax.first, column.minMax.second);
+    if (column.cellColors[row].has_value())
+        return column.cellColors[row].value();
     return QColor();
 }
 
 void FastTableData::setCellTextColor(int row, int col, const QColor& color) {
-    if (row >= 0 && row < static_cast<int>(m_cellTextColors.size()) &&
-        col >= 0 && col < static_cast<int>(m_cellTextColors[row].size())) {
-        m_cellTextColors[row][col] = color;
-    }
+    if (row >= 0 && row < _rows && isColumnResident(col) && !_columns[col]->typed)
+        mutableColumn(col).cellTextColors[row] = color;
 }
 
 QColor FastTableData::cellTextColor(int row, int col) const {
-    if (row >= 0 && row < static_cast<int>(m_cellTextColors.size()) &&
-        col >= 0 && col < static_cast<int>(m_cellTextColors[row].size()) &&
-        m_cellTextColors[row][col].has_value()) {
-        return m_cellTextColors[row][col].value();
-    }
-    return QColor();
+    if (!hasCellTextColor(row, col))
+        return QColor();
+    if (_columns[col]->typed)
+        return getContrastingTextColor(cellColor(row, col));
+    return _columns[col]->cellTextColors[row].value();
 }
 
 bool FastTableData::hasCellTextColor(int row, int col) const {
-    return (row >= 0 && row < static_cast<int>(m_cellTextColors.size()) &&
-            col >= 0 && col < static_cast<int>(m_cellTextColors[row].size()) &&
-            m_cellTextColors[row][col].has_value());
-}
\ No newline at end of file
+    if (row < 0 || row >= _rows || !isColumnResident(col))
+        return false;
+    return _columns[col]->typed || _columns[col]->cellTextColors[row].has_value();
+}
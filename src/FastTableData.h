@@ -7,8 +7,16 @@
 #include <QVariantMap>
 #include <QVariantList>
 #include <optional>
+#include <memory>
+#include <map>
+#include <QHash>
+#include "NumericColumn.h"
 
-// High-performance, flat, row-major table structure for large datasets.
+class RowSource;
+class CachedRowSource;
+class ColumnSource;
+
+// High-performance, column-major table structure for large datasets.
 class FastTableData {
 public:
     using Value = std::variant<double, int, QString>;
@@ -22,16 +30,19 @@ public:
     int colCount() const { return _cols; }
 
     void set(int row, int col, const Value& v);
-    const Value& get(int row, int col) const;
+    Value get(int row, int col) const;
 
     void setColumnName(int col, const QString& name);
     QString columnName(int col) const;
+    int columnIndex(const QString& name) const;
 
     void setColumnIsNumeric(int col, bool isNumeric);
     bool columnIsNumeric(int col) const;
 
     void setColumnMinMax(int col, double minVal, double maxVal);
     void getColumnMinMax(int col, double& minVal, double& maxVal) const;
+    // Label -> background color of a categorical column.
+    std::map<QString, QColor> columnLabelColors(int col) const;
 
     void setPrimaryKeyColumn(int col);
     bool isPrimaryKeyColumn(int col) const;
@@ -42,6 +53,15 @@ public:
     std::vector<std::vector<Value>> getRows() const;
     std::vector<std::vector<Value>> getColumns() const;
 
+    // Reorders rows so that new row r holds old row order[r].
+    void permuteRows(const std::vector<int>& order);
+    // Stable row order by the values of column col, suitable for permuteRows.
+    std::vector<int> sortedRowOrder(int col, bool ascending) const;
+
+    // Progressive loading: blocks must have the same columns as this table.
+    void appendRows(const FastTableData& block);
+    void replaceRows(int first, const FastTableData& block);
+
     void setRowBarColor(int row, const QColor& color);
     QColor rowBarColor(int row) const;
     void setAllRowBarColors(const std::vector<QColor>& colors);
@@ -53,6 +73,9 @@ public:
 
     void clear();
 
+    // Approximate bytes held by the resident cells and colors; sources and shared strings are not counted.
+    qint64 memoryUsage() const;
+
     [[deprecated("Use createTableFromVariantMap in TableDataUtils.h instead. This method will be removed in a future release.")]]
     static FastTableData fromVariantMap(const QVariantMap& map) = delete;
 
@@ -65,8 +88,57 @@ public:
     void fetchMoreColsLeft(int n);
     void fetchMoreColsRight(int n);
 
+    // Row paging: only a window of at most windowRows rows is materialized from the source at a time.
+    void setRowSource(std::shared_ptr<RowSource> source, int windowRows);
+    bool hasRowSource() const { return _rowSource != nullptr; }
+    std::shared_ptr<RowSource> rowSource() const { return _rowSource; }
+    std::shared_ptr<CachedRowSource> rowCache() const;
+    int windowOffset() const { return _windowOffset; }
+    int windowCapacity() const { return _windowCapacity; }
+    int sourceRowCount() const;
+    // Source row shown at table row: follows sorting and the paging window.
+    int sourceRow(int row) const;
+    int availableRowsTop() const;
+    int availableRowsBottom() const;
+    void evictRowsTop(int n);
+    void evictRowsBottom(int n);
+    void repositionWindow(int firstSourceRow);
+
+    // Lazy columns: every source column starts out as metadata only and is read when materialized.
+    // Materialized columns above residentCellBudget cells are evicted least recently used first (0 = no limit).
+    void setColumnSource(std::shared_ptr<ColumnSource> source, qint64 residentCellBudget = 0);
+    bool hasColumnSource() const { return _columnSource != nullptr; }
+    bool isColumnResident(int col) const;
+    // Reading is split so it can run off the GUI thread: missingColumns marks [first, last] as used and lists its
+    // columns that are not resident, loadColumns reads them from a snapshot on any thread, in source row order, and
+    // adoptColumns swaps in the ones still wanted, evicts over budget and returns every column whose residency changed.
+    struct LoadedColumns;
+    std::vector<int> missingColumns(int first, int last);
+    LoadedColumns loadColumns(const std::vector<int>& cols) const;
+    std::vector<int> adoptColumns(LoadedColumns loaded, int first, int last);
+
     void addColumn(const QString& name, const Value& defaultValue = Value{});
     bool removeColumn(const QString& name);
+    bool removeColumnAt(int col);
+    void addColumns(const std::vector<std::pair<QString, Value>>& columns);
+    // Appends a numeric column kept in its source element type; its range is computed and its cell colors derive from it.
+    void appendNumericColumn(const QString& name, NumericBuffer values);
+    bool isTypedColumn(int col) const;
+    // Native values of a typed column, null for other columns.
+    const NumericBuffer* numericColumn(int col) const;
+    // Values of column col at the given table rows; lazy columns that are not resident are read from their source.
+    bool readCells(int col, const std::vector<int>& rows, std::vector<Value>& out) const;
+
+    // Id of the dataset a column was read from, used to rebuild only the columns of a changed dataset.
+    void setColumnOrigin(int col, const QString& datasetId);
+    QString columnOrigin(int col) const;
+    // Swaps in the columns of block, which has the same rows in source order, for the columns with the same origins.
+    // Returns the replaced columns, or nothing when the origins or column counts do not match.
+    std::vector<int> replaceColumns(const FastTableData& block);
+
+    // Appends a fully built column, one value per row; label columns are colored through labelColors.
+    void appendColumn(const QString& name, std::vector<Value> values, bool isNumeric, const std::map<QString, QColor>& labelColors = {});
+    void removeColumns(std::vector<int> cols);
 
     void setCellColor(int row, int col, const QColor& color);
     QColor cellColor(int row, int col) const;
@@ -76,14 +148,47 @@ public:
     bool hasCellTextColor(int row, int col) const;
 
 private:
+    // One column buffer with its metadata and cell colors. Columns are shared between copies of the
+    // table and only cloned when written, so snapshots and column add/remove never touch the cells.
+    struct Column {
+        QString name;
+        bool isNumeric = true;
+        std::pair<double, double> minMax{ 0.0, 0.0 };
+        std::vector<Value> values;
+        bool typed = false;      // values live in numeric instead, without per-cell colors
+        NumericBuffer numeric;
+        std::vector<std::optional<QColor>> cellColors;
+        std::vector<std::optional<QColor>> cellTextColors;
+        std::map<QString, QColor> labelColors;
+        int sourceColumn = -1; // column of _columnSource, -1 when the column is always resident
+        QString origin;        // dataset id, empty when unknown
+    };
+
+    struct LoadedColumns {
+        std::shared_ptr<ColumnSource> source;
+        std::vector<int> columns;
+        std::vector<std::shared_ptr<Column>> data; // null where the read failed
+    };
+
+    static void colorColumn(Column& column, int first, int count);
+    static void permuteColumn(Column& column, const std::vector<int>& order);
+    Column& mutableColumn(int col);
+    void rebuildColumnIndex();
+    void insertRowBlock(int at, const std::vector<Value>& values, int count);
+    void colorRows(int first, int count);
+
     int _rows = 0, _cols = 0;
-    std::vector<Value> _data;
-    std::vector<QString> _colNames;
-    std::vector<bool> _colIsNumeric;
-    std::vector<std::pair<double, double>> _colMinMax;
+    std::vector<std::shared_ptr<Column>> _columns;
+    QHash<QString, int> _columnIndex; // first column with a given name
     int _primaryKeyCol = -1;
     std::vector<QColor> _rowBarColors;
     std::vector<bool> _rowVisible;
-    std::vector<std::vector<std::optional<QColor>>> m_cellColors;
-    std::vector<std::vector<std::optional<QColor>>> m_cellTextColors;
+    std::shared_ptr<RowSource> _rowSource;
+    int _windowOffset = 0;
+    int _windowCapacity = 0;
+    std::shared_ptr<ColumnSource> _columnSource;
+    qint64 _residentCellBudget = 0;
+    std::vector<int> _sourceRowOf;        // table row -> source row, empty while unsorted
+    std::vector<quint64> _columnLastUse;  // per column, for evicting lazy columns
+    quint64 _useClock = 0;
 };
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "FileRowSource.h"
+#include <QStringList>
+#include <algorithm>
+#include <limits>
+
+namespace {
+    // Every kIndexStride-th data line gets its byte offset recorded.
+    constexpr int kIndexStride = 1024;
+
+    QByteArray chompLine(QByteArray line) {
+        while (!line.isEmpty() && (line.endsWith('\n') || line.endsWith('\r')))
+            line.chop(1);
+        return line;
+    }
+
+    // Reads one record; a quoted field may span lines, so lines are joined while an odd number of quotes is open.
+    QByteArray readRecord(QFile& file) {
+        QByteArray record = file.readLine();
+        qsizetype quotes = record.count('"');
+        while (quotes % 2 != 0 && !file.atEnd()) {
+            const QByteArray line = file.readLine();
+            quotes += line.count('"');
+            record += line;
+        }
+        return chompLine(record);
+    }
+
+    // Missing numeric cells, as the importer treats them.
+    bool isMissing(const QString& field) {
+        return field.isEmpty() || field == QLatin1String("NA");
+    }
+}
+
+FileRowSource::FileRowSource(const QString& filePath, QChar delimiter)
+    : _filePath(filePath)
+{
+    if (!delimiter.isNull())
+        _delimiter = delimiter.toLatin1();
+    else if (filePath.endsWith(".tsv", Qt::CaseInsensitive) || filePath.endsWith(".tab", Qt::CaseInsensitive))
+        _delimiter = '\t';
+    scan();
+}
+
+QStringList FileRowSource::splitLine(const QByteArray& line, char delimiter)
+{
+    QStringList fields;
+    QByteArray field;
+    bool inQuotes = false;
+    for (int i = 0; i < line.size(); ++i) {
+        const char ch = line[i];
+        if (ch == '"') {
+            if (inQuotes && i + 1 < line.size() && line[i + 1] == '"') {
+                field += '"';
+                ++i;
+            } else {
+                inQuotes = !inQuotes;
+            }
+        } else if (ch == delimiter && !inQuotes) {
+            fields << QString::fromUtf8(field);
+            field.clear();
+        } else {
+            field += ch;
+        }
+    }
+    fields << QString::fromUtf8(field);
+    return fields;
+}
+
+void FileRowSource::scan()
+{
+    QFile file(_filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    const QByteArray header = readRecord(file);
+    if (header.isEmpty())
+        return;
+    if (_delimiter == ',' && !header.contains(',') && header.contains('\t'))
+        _delimiter = '\t';
+
+    const QStringList names = splitLine(header, _delimiter);
+    const int cols = names.size();
+    for (int c = 0; c < cols; ++c)
+        _colNames.push_back(names[c].isEmpty() ? QString("Column %1").arg(c + 1) : names[c]);
+    _colIsNumeric.assign(cols, true);
+    std::vector<double> minVals(cols, std::numeric_limits<double>::max());
+    std::vector<double> maxVals(cols, std::numeric_limits<double>::lowest());
+
+    while (!file.atEnd()) {
+        const qint64 offset = file.pos();
+        const QByteArray line = readRecord(file);
+        if (line.isEmpty())
+            continue;
+        if (_rows % kIndexStride == 0)
+            _lineOffsets.push_back(offset);
+
+        const QStringList fields = splitLine(line, _delimiter);
+        for (int c = 0; c < cols && c < fields.size(); ++c) {
+            if (!_colIsNumeric[c] || isMissing(fields[c]))
+                continue;
+            bool ok = false;
+            const double value = fields[c].toDouble(&ok);
+            if (!ok) {
+                _colIsNumeric[c] = false;
+                continue;
+            }
+            minVals[c] = std::min(minVals[c], value);
+            maxVals[c] = std::max(maxVals[c], value);
+        }
+        ++_rows;
+    }
+
+    _colMinMax.resize(cols, { 0.0, 0.0 });
+    for (int c = 0; c < cols; ++c) {
+        if (_colIsNumeric[c] && minVals[c] <= maxVals[c])
+            _colMinMax[c] = { minVals[c], maxVals[c] };
+    }
+    _valid = true;
+}
+
+QString FileRowSource::columnName(int col) const
+{
+    if (col >= 0 && col < colCount()) return _colNames[col];
+    return {};
+}
+
+bool FileRowSource::columnIsNumeric(int col) const
+{
+    if (col >= 0 && col < colCount()) return _colIsNumeric[col];
+    return true;
+}
+
+void FileRowSource::getColumnMinMax(int col, double& minVal, double& maxVal) const
+{
+    if (col >= 0 && col < colCount()) {
+        minVal = _colMinMax[col].first;
+        maxVal = _colMinMax[col].second;
+    } else {
+        minVal = 0.0;
+        maxVal = 0.0;
+    }
+}
+
+bool FileRowSource::readRows(int first, int count, std::vector<FastTableData::Value>& out) const
+{
+    if (!_valid || first < 0 || count < 0 || first + count > _rows)
+        return false;
+
+    const int cols = colCount();
+    out.assign(static_cast<size_t>(count) * cols, FastTableData::Value{});
+    if (count == 0)
+        return true;
+
+    std::lock_guard<std::mutex> lock(_fileMutex);
+    if (!_file) {
+        _file = std::make_unique<QFile>(_filePath);
+        if (!_file->open(QIODevice::ReadOnly)) {
+            _file.reset();
+            return false;
+        }
+    }
+    if (!_file->seek(_lineOffsets[first / kIndexStride]))
+        return false;
+
+    int lineNumber = (first / kIndexStride) * kIndexStride;
+    int r = 0;
+    while (r < count && !_file->atEnd()) {
+        const QByteArray line = readRecord(*_file);
+        if (line.isEmpty())
+            continue;
+        if (lineNumber++ < first)
+            continue;
+
+        const QStringList fields = splitLine(line, _delimiter);
+        for (int c = 0; c < cols; ++c) {
+            const QString field = c < fields.size() ? fields[c] : QString();
+            auto& value = out[static_cast<size_t>(r) * cols + c];
+            // Missing numeric cells stay empty, they have no value to show, bar or color.
+            if (_colIsNumeric[c] && !isMissing(field))
+                value = field.toDouble();
+            else
+                value = field;
+        }
+        ++r;
+    }
+    return r == count;
+}
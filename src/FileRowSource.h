@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QFile>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "RowSource.h"
+
+// Pages rows from a delimited text file (CSV/TSV) with a header line, keeping only a sparse record-offset index in memory.
+// Quoted fields may contain delimiters, doubled quotes and line breaks.
+class FileRowSource : public RowSource {
+public:
+    explicit FileRowSource(const QString& filePath, QChar delimiter = QChar());
+
+    bool isValid() const { return _valid; }
+
+    int rowCount() const override { return _rows; }
+    int colCount() const override { return static_cast<int>(_colNames.size()); }
+
+    QString columnName(int col) const override;
+    bool columnIsNumeric(int col) const override;
+    void getColumnMinMax(int col, double& minVal, double& maxVal) const override;
+
+    bool readRows(int first, int count, std::vector<FastTableData::Value>& out) const override;
+
+    static QStringList splitLine(const QByteArray& line, char delimiter);
+
+private:
+    void scan();
+
+    QString _filePath;
+    char _delimiter = ',';
+    bool _valid = false;
+    int _rows = 0;
+    std::vector<QString> _colNames;
+    std::vector<bool> _colIsNumeric;
+    std::vector<std::pair<double, double>> _colMinMax;
+    std::vector<qint64> _lineOffsets; // byte offset of every kIndexStride-th data line
+    mutable std::unique_ptr<QFile> _file;
+    mutable std::mutex _fileMutex;
+};
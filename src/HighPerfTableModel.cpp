@@ -1,35 +1,131 @@
 #include "HighPerfTableModel.h"
 #include "FastTableData.h"
 #include "TableDataUtils.h"
+#include "ModelTransaction.h"
+#include <QtConcurrent>
 #include <algorithm>
+#include <functional>
+#include <numeric>
 
 HighPerfTableModel::HighPerfTableModel(QObject* parent)
     : QAbstractTableModel(parent)
-{}
+    , _data(std::make_shared<FastTableData>())
+{
+    connect(&_columnLoad, &QFutureWatcherBase::finished, this, &HighPerfTableModel::onColumnsLoaded);
+}
+
+std::shared_ptr<const FastTableData> HighPerfTableModel::snapshot() const {
+    return _data;
+}
+
+FastTableData& HighPerfTableModel::mutableTable() {
+    // Snapshots handed to worker threads keep their copy, writes go to a private one.
+    if (_data.use_count() > 1)
+        _data = std::make_shared<FastTableData>(*_data);
+    return *_data;
+}
 
 void HighPerfTableModel::setData(const FastTableData& data) {
-    beginResetModel();
-    _data = data;
-    endResetModel();
+    // Reads still running for the previous table are dropped when they arrive.
+    _pendingSortColumn = -1;
+    _requestedColumns = { -1, -1 };
+    bool sameColumns = !_data->hasRowSource() && !data.hasRowSource() && _data->colCount() == data.colCount() && data.colCount() > 0;
+    for (int c = 0; sameColumns && c < data.colCount(); ++c)
+        sameColumns = _data->columnName(c) == data.columnName(c) && _data->columnIsNumeric(c) == data.columnIsNumeric(c);
+
+    if (!sameColumns || _rowFilterActive) {
+        beginResetModel();
+        _data = std::make_shared<FastTableData>(data);
+        if (isFiltering())
+            _visibleRows = filteredRows(0);
+        endResetModel();
+        return;
+    }
+
+    // Same column layout: keep selection, scroll position and header sizes, only report what changed.
+    const int oldRows = _data->rowCount();
+    const int newRows = data.rowCount();
+    if (newRows < oldRows) {
+        beginRemoveRows(QModelIndex(), newRows, oldRows - 1);
+        _data = std::make_shared<FastTableData>(data);
+        endRemoveRows();
+    } else if (newRows > oldRows) {
+        beginInsertRows(QModelIndex(), oldRows, newRows - 1);
+        _data = std::make_shared<FastTableData>(data);
+        endInsertRows();
+    } else {
+        _data = std::make_shared<FastTableData>(data);
+    }
+    if (newRows > 0)
+        emit dataChanged(index(0, 0), index(newRows - 1, columnCount() - 1));
+    emit headerDataChanged(Qt::Vertical, 0, std::max(newRows - 1, 0));
+}
+
+void HighPerfTableModel::appendRows(const FastTableData& block) {
+    if (block.rowCount() == 0 || block.colCount() != columnCount())
+        return;
+    if (isFiltering()) {
+        // Appended rows come after every table row shown so far.
+        const int firstTableRow = _data->rowCount();
+        mutableTable().appendRows(block);
+        const auto added = filteredRows(firstTableRow);
+        if (added.empty())
+            return;
+        beginInsertRows(QModelIndex(), rowCount(), rowCount() + static_cast<int>(added.size()) - 1);
+        _visibleRows.insert(_visibleRows.end(), added.begin(), added.end());
+        endInsertRows();
+        return;
+    }
+    const int first = rowCount();
+    beginInsertRows(QModelIndex(), first, first + block.rowCount() - 1);
+    mutableTable().appendRows(block);
+    endInsertRows();
+}
+
+void HighPerfTableModel::refineRows(int first, const FastTableData& block) {
+    if (block.colCount() != columnCount() || first < 0 || first + block.rowCount() > _data->rowCount())
+        return;
+    auto& table = mutableTable();
+    table.replaceRows(first, block);
+    for (int col = 0; col < block.colCount(); ++col) {
+        double minVal = 0.0, maxVal = 0.0;
+        block.getColumnMinMax(col, minVal, maxVal);
+        table.setColumnMinMax(col, minVal, maxVal);
+    }
+    // Bars and colors of every row depend on the column ranges.
+    if (rowCount() > 0)
+        emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+}
+
+bool HighPerfTableModel::replaceColumns(const FastTableData& block) {
+    if (block.colCount() == 0 || block.rowCount() != _data->rowCount() || _data->hasRowSource() || _data->hasColumnSource())
+        return false;
+    const auto replaced = mutableTable().replaceColumns(block);
+    if (replaced.empty())
+        return false;
+    emit headerDataChanged(Qt::Horizontal, replaced.front(), replaced.back());
+    if (rowCount() > 0)
+        emit dataChanged(index(0, replaced.front()), index(rowCount() - 1, replaced.back()));
+    return true;
 }
 
 int HighPerfTableModel::rowCount(const QModelIndex&) const {
-    return _data.rowCount();
+    return isFiltering() ? static_cast<int>(_visibleRows.size()) : _data->rowCount();
 }
 
 int HighPerfTableModel::columnCount(const QModelIndex&) const {
-    return _data.colCount();
+    return _data->colCount();
 }
 
 QVariant HighPerfTableModel::data(const QModelIndex& index, int role) const {
     if (!index.isValid())
         return QVariant();
 
-    int row = index.row();
+    int row = tableRow(index.row());
     int col = index.column();
 
-    if (_showBars && role == Qt::UserRole + 1 && isNumericalColumn(index.column())) {
-        const auto& v = _data.get(index.row(), index.column());
+    if (_showBars && role == Qt::UserRole + 1 && isNumericalColumn(col)) {
+        const auto& v = _data->get(row, col);
         if (std::holds_alternative<double>(v))
             return static_cast<float>(std::get<double>(v));
         if (std::holds_alternative<int>(v))
@@ -37,7 +133,7 @@ QVariant HighPerfTableModel::data(const QModelIndex& index, int role) const {
         return {};
     }
     if (!_showBars && role == Qt::DisplayRole) {
-        const auto& v = _data.get(index.row(), index.column());
+        const auto& v = _data->get(row, col);
         if (std::holds_alternative<double>(v))
             return std::get<double>(v);
         if (std::holds_alternative<int>(v))
@@ -47,7 +143,7 @@ QVariant HighPerfTableModel::data(const QModelIndex& index, int role) const {
         return {};
     }
     if (_showBars && role == Qt::DisplayRole) {
-        const auto& v = _data.get(index.row(), index.column());
+        const auto& v = _data->get(row, col);
         if (std::holds_alternative<double>(v))
             return std::get<double>(v);
         if (std::holds_alternative<int>(v))
@@ -57,13 +153,13 @@ QVariant HighPerfTableModel::data(const QModelIndex& index, int role) const {
         return {};
     }
     if (role == Qt::ForegroundRole) {
-        if (_data.hasCellTextColor(row, col)) {
-            return _data.cellTextColor(row, col);
+        if (_data->hasCellTextColor(row, col)) {
+            return _data->cellTextColor(row, col);
         }
     }
     if (role == Qt::BackgroundRole) {
         if (isNumericalColumn(col) && !_showBars) {
-            const auto& val = _data.get(row, col);
+            const auto& val = _data->get(row, col);
             if (std::holds_alternative<double>(val)) {
                 float fval = static_cast<float>(std::get<double>(val));
                 return colorForValue(col, fval);
@@ -74,14 +170,14 @@ QVariant HighPerfTableModel::data(const QModelIndex& index, int role) const {
             }
         }
 
-        QColor color = _data.cellColor(row, col);
+        QColor color = _data->cellColor(row, col);
         if (color.isValid())
             return color;
         
-        if (!_data.columnIsNumeric(col)) {
+        if (!_data->columnIsNumeric(col)) {
             return QColor();
         }
-        return _data.rowBarColor(index.row());
+        return _data->rowBarColor(row);
     }
     return {};
 }
@@ -90,18 +186,18 @@ QVariant HighPerfTableModel::headerData(int section, Qt::Orientation orientation
     if (role != Qt::DisplayRole)
         return QVariant();
     if (orientation == Qt::Horizontal)
-        return _data.columnName(section);
+        return _data->columnName(section);
     else
-        return QString::number(section);
+        return QString::number(tableRow(section) + _data->windowOffset());
 }
 
 bool HighPerfTableModel::isNumericalColumn(int col) const {
-    return _data.columnIsNumeric(col);
+    return _data->columnIsNumeric(col);
 }
 
 void HighPerfTableModel::getColumnMinMax(int col, float& minVal, float& maxVal) const {
     double minD, maxD;
-    _data.getColumnMinMax(col, minD, maxD);
+    _data->getColumnMinMax(col, minD, maxD);
     minVal = static_cast<float>(minD);
     maxVal = static_cast<float>(maxD);
 }
@@ -117,72 +213,349 @@ bool HighPerfTableModel::showBars() const {
 }
 
 int HighPerfTableModel::primaryKeyColumn() const {
-    return _data.primaryKeyColumn();
+    return _data->primaryKeyColumn();
 }
 
 void HighPerfTableModel::sort(int column, Qt::SortOrder order) {
-    if (column < 0 || column >= _data.colCount())
+    // A paged table only holds a window of rows, sorting it would not order the table as a whole.
+    if (column < 0 || column >= _data->colCount() || _data->hasRowSource())
+        return;
+    // A lazy column is read first, the sort follows once it arrived.
+    _pendingSortColumn = -1;
+    if (!_data->isColumnResident(column)) {
+        _pendingSortColumn = column;
+        _pendingSortOrder = order;
+        ensureColumnsResident(column, column);
         return;
+    }
 
-    std::vector<int> rowIndices(_data.rowCount());
-    std::iota(rowIndices.begin(), rowIndices.end(), 0);
-
-    auto valueLess = [&](int a, int b) {
-        const auto& va = _data.get(a, column);
-        const auto& vb = _data.get(b, column);
-        double da = 0, db = 0;
-        if (std::holds_alternative<double>(va)) da = std::get<double>(va);
-        else if (std::holds_alternative<int>(va)) da = static_cast<double>(std::get<int>(va));
-        else if (std::holds_alternative<QString>(va)) return std::get<QString>(va) < std::get<QString>(vb);
-        if (std::holds_alternative<double>(vb)) db = std::get<double>(vb);
-        else if (std::holds_alternative<int>(vb)) db = static_cast<double>(std::get<int>(vb));
-        else if (std::holds_alternative<QString>(vb)) return std::get<QString>(va) < std::get<QString>(vb);
-        return da < db;
-    };
+    const std::vector<int> rowIndices = _data->sortedRowOrder(column, order == Qt::AscendingOrder);
+
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+    mutableTable().permuteRows(rowIndices);
+
+    // rowIndices maps new row -> old row, persistent indexes need old row -> new row.
+    std::vector<int> newRowOf(rowIndices.size());
+    for (int r = 0; r < static_cast<int>(rowIndices.size()); ++r)
+        newRowOf[rowIndices[r]] = r;
+
+    // Filtered, the same rows stay shown in the new order; view rows go through their table rows.
+    if (isFiltering()) {
+        const std::vector<int> oldVisibleRows = std::move(_visibleRows);
+        _visibleRows = filteredRows(0);
+        std::vector<int> viewRowOf(_data->rowCount(), -1);
+        for (int v = 0; v < static_cast<int>(_visibleRows.size()); ++v)
+            viewRowOf[_visibleRows[v]] = v;
+        for (int& row : newRowOf)
+            row = viewRowOf[row];
+        std::vector<int> remapped(oldVisibleRows.size());
+        for (int v = 0; v < static_cast<int>(oldVisibleRows.size()); ++v)
+            remapped[v] = newRowOf[oldVisibleRows[v]];
+        newRowOf = std::move(remapped);
+    }
 
-    if (order == Qt::AscendingOrder)
-        std::stable_sort(rowIndices.begin(), rowIndices.end(), valueLess);
-    else
-        std::stable_sort(rowIndices.begin(), rowIndices.end(), [&](int a, int b) { return valueLess(b, a); });
-
-    FastTableData newData = _data;
-    for (int r = 0; r < _data.rowCount(); ++r) {
-        for (int c = 0; c < _data.colCount(); ++c) {
-            newData.set(r, c, _data.get(rowIndices[r], c));
-            newData.setCellColor(r, c, _data.cellColor(rowIndices[r], c));
-            newData.setCellTextColor(r, c, _data.cellTextColor(rowIndices[r], c));
+    const QModelIndexList oldIndexes = persistentIndexList();
+    QModelIndexList newIndexes;
+    newIndexes.reserve(oldIndexes.size());
+    for (const QModelIndex& oldIndex : oldIndexes)
+        newIndexes << index(newRowOf[oldIndex.row()], oldIndex.column());
+    changePersistentIndexList(oldIndexes, newIndexes);
+
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+void HighPerfTableModel::requestMoreRowsTop(int n)
+{
+    if (!_data->canFetchMoreRowsTop(n))
+        return;
+
+    const int count = std::min(n, _data->availableRowsTop());
+    const bool wasPaging = _paging;
+    _paging = true;
+    beginInsertRows(QModelIndex(), 0, count - 1);
+    mutableTable().fetchMoreRowsTop(count);
+    endInsertRows();
+
+    // Keep the resident window bounded by dropping the rows furthest from the viewport.
+    const int excess = _data->rowCount() - _data->windowCapacity();
+    if (excess > 0) {
+        beginRemoveRows(QModelIndex(), rowCount() - excess, rowCount() - 1);
+        mutableTable().evictRowsBottom(excess);
+        endRemoveRows();
+    }
+    _paging = wasPaging;
+}
+
+void HighPerfTableModel::requestMoreRowsBottom(int n)
+{
+    if (!_data->canFetchMoreRowsBottom(n))
+        return;
+
+    const int count = std::min(n, _data->availableRowsBottom());
+    int oldCount = rowCount();
+    const bool wasPaging = _paging;
+    _paging = true;
+    beginInsertRows(QModelIndex(), oldCount, oldCount + count - 1);
+    mutableTable().fetchMoreRowsBottom(count);
+    endInsertRows();
+
+    const int excess = _data->rowCount() - _data->windowCapacity();
+    if (excess > 0) {
+        beginRemoveRows(QModelIndex(), 0, excess - 1);
+        mutableTable().evictRowsTop(excess);
+        endRemoveRows();
+    }
+    _paging = wasPaging;
+}
+
+bool HighPerfTableModel::isPaged() const {
+    return _data->hasRowSource();
+}
+
+bool HighPerfTableModel::isPaging() const {
+    return _paging;
+}
+
+int HighPerfTableModel::windowOffset() const {
+    return _data->windowOffset();
+}
+
+int HighPerfTableModel::sourceRowCount() const {
+    return _data->sourceRowCount();
+}
+
+int HighPerfTableModel::sourceRow(int row) const {
+    return _data->sourceRow(tableRow(row));
+}
+
+int HighPerfTableModel::tableRow(int row) const {
+    return isFiltering() && row >= 0 && row < static_cast<int>(_visibleRows.size()) ? _visibleRows[row] : row;
+}
+
+RowSelection HighPerfTableModel::rowSelection(const QItemSelection& selection) const {
+    if (!isFiltering())
+        return RowSelection::fromItemSelection(selection, _data);
+
+    // _visibleRows is strictly ascending, so _visibleRows[v] - v never decreases and is constant exactly over a run of
+    // consecutive table rows: each view range maps onto its runs with one binary search per run.
+    std::vector<std::pair<int, int>> ranges;
+    for (const QItemSelectionRange& range : selection) {
+        const int end = std::min(range.bottom() + 1, static_cast<int>(_visibleRows.size()));
+        for (int v = std::max(range.top(), 0); v < end;) {
+            const int offset = _visibleRows[v] - v;
+            int lo = v + 1, hi = end;
+            while (lo < hi) {
+                const int mid = lo + (hi - lo) / 2;
+                if (_visibleRows[mid] - mid == offset)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            ranges.emplace_back(_visibleRows[v], _visibleRows[lo - 1]);
+            v = lo;
         }
-        newData.setRowBarColor(r, _data.rowBarColor(rowIndices[r]));
     }
+    return RowSelection(std::move(ranges), _data);
+}
+
+std::optional<std::vector<int>> HighPerfTableModel::filteredTableRows() const {
+    if (!isFiltering())
+        return std::nullopt;
+    return _visibleRows;
+}
+
+bool HighPerfTableModel::isFiltering() const {
+    return _rowFilterActive && !_data->hasRowSource();
+}
+
+std::vector<int> HighPerfTableModel::filteredRows(int firstTableRow) const {
+    std::vector<int> rows;
+    for (int r = firstTableRow; r < _data->rowCount(); ++r) {
+        const int source = _data->sourceRow(r);
+        if (_data->isRowVisible(r) && source < static_cast<int>(_shownSourceRows.size()) && _shownSourceRows[source])
+            rows.push_back(r);
+    }
+    return rows;
+}
+
+void HighPerfTableModel::setRowFilter(std::vector<bool> shownSourceRows) {
+    const bool wasFiltering = isFiltering();
+    const std::vector<int> oldRows = wasFiltering ? _visibleRows : std::vector<int>();
+    _shownSourceRows = std::move(shownSourceRows);
+
+    if (!wasFiltering) {
+        beginResetModel();
+        _rowFilterActive = true;
+        if (isFiltering())
+            _visibleRows = filteredRows(0);
+        endResetModel();
+        return;
+    }
+
+    std::vector<int> newRows = filteredRows(0);
+    std::vector<bool> inOld(_data->rowCount()), inNew(_data->rowCount());
+    for (int r : oldRows) inOld[r] = true;
+    for (int r : newRows) inNew[r] = true;
+
+    // Runs of view rows to remove (in old view rows) and to insert (in new view rows).
+    auto runsOf = [](const std::vector<int>& rows, const std::vector<bool>& keep) {
+        std::vector<std::pair<int, int>> runs;
+        for (int v = 0; v < static_cast<int>(rows.size()); ++v) {
+            if (keep[rows[v]])
+                continue;
+            if (!runs.empty() && runs.back().second == v - 1)
+                runs.back().second = v;
+            else
+                runs.emplace_back(v, v);
+        }
+        return runs;
+    };
+    const auto removed = runsOf(oldRows, inNew);
+    const auto inserted = runsOf(newRows, inOld);
+
+    // Small changes keep selection and scroll position, a new filter altogether resets.
+    constexpr size_t kMaxIncrementalRuns = 512;
+    if (removed.size() + inserted.size() > kMaxIncrementalRuns) {
+        beginResetModel();
+        _visibleRows = std::move(newRows);
+        endResetModel();
+        return;
+    }
+
+    // Back to front, so earlier runs keep their positions.
+    for (auto it = removed.rbegin(); it != removed.rend(); ++it) {
+        beginRemoveRows(QModelIndex(), it->first, it->second);
+        _visibleRows.erase(_visibleRows.begin() + it->first, _visibleRows.begin() + it->second + 1);
+        endRemoveRows();
+    }
+    // Front to back, every run lands behind the new rows already in place.
+    for (const auto& [first, last] : inserted) {
+        beginInsertRows(QModelIndex(), first, last);
+        _visibleRows.insert(_visibleRows.begin() + first, newRows.begin() + first, newRows.begin() + last + 1);
+        endInsertRows();
+    }
+}
+
+void HighPerfTableModel::clearRowFilter() {
+    if (!_rowFilterActive)
+        return;
     beginResetModel();
-    _data = newData;
+    _rowFilterActive = false;
+    _shownSourceRows.clear();
+    _visibleRows.clear();
     endResetModel();
 }
 
-void HighPerfTableModel::requestMoreRowsTop(int n)
+bool HighPerfTableModel::hasRowFilter() const {
+    return _rowFilterActive;
+}
+
+void HighPerfTableModel::ensureSourceRowsResident(int first, int last)
 {
-    if (_data.canFetchMoreRowsTop(n)) {
-        beginInsertRows(QModelIndex(), 0, n - 1);
-        _data.fetchMoreRowsTop(n);
-        endInsertRows();
+    if (!_data->hasRowSource())
+        return;
+
+    first = std::max(first, 0);
+    last = std::min(last, _data->sourceRowCount() - 1);
+    if (last < first)
+        return;
+
+    const int windowFirst = _data->windowOffset();
+    const int windowEnd = windowFirst + _data->rowCount();
+    const int span = last - first + 1;
+
+    // Far jumps (scrollbar drags) re-anchor the window instead of paging through everything in between.
+    if (_data->rowCount() == 0 || last < windowFirst - span || first > windowEnd + span || span > _data->windowCapacity() / 2) {
+        moveWindow(first, std::max(span, _data->windowCapacity() / 2));
+        return;
     }
+    if (first < windowFirst)
+        requestMoreRowsTop(windowFirst - first);
+    if (last >= _data->windowOffset() + _data->rowCount())
+        requestMoreRowsBottom(last + 1 - (_data->windowOffset() + _data->rowCount()));
 }
 
-void HighPerfTableModel::requestMoreRowsBottom(int n)
+bool HighPerfTableModel::hasLazyColumns() const {
+    return _data->hasColumnSource();
+}
+
+void HighPerfTableModel::ensureColumnsResident(int first, int last)
 {
-    int oldCount = rowCount();
-    if (_data.canFetchMoreRowsBottom(n)) {
-        beginInsertRows(QModelIndex(), oldCount, oldCount + n - 1);
-        _data.fetchMoreRowsBottom(n);
+    if (!_data->hasColumnSource() || _data->colCount() == 0)
+        return;
+    if (_columnLoad.isRunning()) {
+        _requestedColumns = { first, last };
+        return;
+    }
+
+    const auto missing = mutableTable().missingColumns(first, last);
+    if (missing.empty())
+        return;
+    _loadingColumns = { first, last };
+    _columnLoad.setFuture(QtConcurrent::run([table = snapshot(), missing]() { return table->loadColumns(missing); }));
+}
+
+void HighPerfTableModel::waitForColumnLoad()
+{
+    _columnLoad.waitForFinished();
+}
+
+void HighPerfTableModel::onColumnsLoaded()
+{
+    if (_columnLoad.future().resultCount() > 0) {
+        const auto changed = mutableTable().adoptColumns(_columnLoad.result(), _loadingColumns.first, _loadingColumns.second);
+        // Loaded columns got their values and ranges, evicted ones read as empty again.
+        if (!changed.empty()) {
+            if (rowCount() > 0) {
+                const auto [minCol, maxCol] = std::minmax_element(changed.begin(), changed.end());
+                emit dataChanged(index(0, *minCol), index(rowCount() - 1, *maxCol));
+            }
+            emit lazyColumnsChanged();
+        }
+    }
+
+    if (_pendingSortColumn >= 0) {
+        const bool attempted = _pendingSortColumn >= _loadingColumns.first && _pendingSortColumn <= _loadingColumns.second;
+        if (_pendingSortColumn < _data->colCount() && _data->isColumnResident(_pendingSortColumn))
+            sort(_pendingSortColumn, _pendingSortOrder);
+        else if (attempted)
+            _pendingSortColumn = -1; // the column could not be read
+    }
+
+    const auto requested = _requestedColumns;
+    _requestedColumns = { -1, -1 };
+    if (requested.first >= 0)
+        ensureColumnsResident(requested.first, requested.second);
+    if (_pendingSortColumn >= 0)
+        ensureColumnsResident(_pendingSortColumn, _pendingSortColumn);
+}
+
+void HighPerfTableModel::moveWindow(int firstSourceRow, int count)
+{
+    const bool wasPaging = _paging;
+    _paging = true;
+    if (rowCount() > 0) {
+        beginRemoveRows(QModelIndex(), 0, rowCount() - 1);
+        mutableTable().evictRowsBottom(rowCount());
+        endRemoveRows();
+    }
+
+    mutableTable().repositionWindow(firstSourceRow);
+    count = std::min({ count, _data->windowCapacity(), _data->availableRowsBottom() });
+    if (count > 0) {
+        beginInsertRows(QModelIndex(), 0, count - 1);
+        mutableTable().fetchMoreRowsBottom(count);
         endInsertRows();
     }
+    _paging = wasPaging;
 }
 
 void HighPerfTableModel::requestMoreColsLeft(int n)
 {
-    if (_data.canFetchMoreColsLeft(n)) {
+    if (_data->canFetchMoreColsLeft(n)) {
         beginInsertColumns(QModelIndex(), 0, n - 1);
-        _data.fetchMoreColsLeft(n);
+        mutableTable().fetchMoreColsLeft(n);
         endInsertColumns();
     }
 }
@@ -190,40 +563,53 @@ void HighPerfTableModel::requestMoreColsLeft(int n)
 void HighPerfTableModel::requestMoreColsRight(int n)
 {
     int oldCount = columnCount();
-    if (_data.canFetchMoreColsRight(n)) {
+    if (_data->canFetchMoreColsRight(n)) {
         beginInsertColumns(QModelIndex(), oldCount, oldCount + n - 1);
-        _data.fetchMoreColsRight(n);
+        mutableTable().fetchMoreColsRight(n);
         endInsertColumns();
     }
 }
 
 void HighPerfTableModel::addColumn(const QString& name, const FastTableData::Value& defaultValue) {
-    beginResetModel();
-    _data.addColumn(name, defaultValue);
-    endResetModel();
+    const int col = columnCount();
+    beginInsertColumns(QModelIndex(), col, col);
+    mutableTable().addColumn(name, defaultValue);
+    endInsertColumns();
 }
 
 void HighPerfTableModel::addColumns(const std::vector<QString>& names, const FastTableData::Value& defaultValue) {
-    beginResetModel();
-    for (const auto& name : names) {
-        _data.addColumn(name, defaultValue);
-    }
-    endResetModel();
+    ModelTransaction transaction(*this);
+    for (const auto& name : names)
+        transaction.addColumn(name, defaultValue);
 }
 
 bool HighPerfTableModel::removeColumn(const QString& name) {
-    beginResetModel();
-    bool result = _data.removeColumn(name);
-    endResetModel();
-    return result;
+    const int col = _data->columnIndex(name);
+    if (col < 0)
+        return false;
+    beginRemoveColumns(QModelIndex(), col, col);
+    mutableTable().removeColumnAt(col);
+    dropColumnColorMaps({ col });
+    endRemoveColumns();
+    return true;
 }
 
 void HighPerfTableModel::removeColumns(const std::vector<QString>& names) {
-    beginResetModel();
-    for (const auto& name : names) {
-        _data.removeColumn(name);
+    ModelTransaction transaction(*this);
+    for (const auto& name : names)
+        transaction.removeColumn(name);
+}
+
+void HighPerfTableModel::dropColumnColorMaps(const std::vector<int>& removedColumns) {
+    // removedColumns is sorted; surviving columns move down by the number of removed columns before them.
+    std::map<int, ColorMapType> shifted;
+    for (const auto& [col, cmap] : m_columnColorMaps) {
+        const auto it = std::lower_bound(removedColumns.begin(), removedColumns.end(), col);
+        if (it != removedColumns.end() && *it == col)
+            continue;
+        shifted[col - static_cast<int>(it - removedColumns.begin())] = cmap;
     }
-    endResetModel();
+    m_columnColorMaps = std::move(shifted);
 }
 
 void HighPerfTableModel::setDefaultClusterBackgroundColor(const QColor& color)
@@ -262,8 +648,8 @@ QColor HighPerfTableModel::colorForValue(int col, float value) const {
 
 void HighPerfTableModel::changeColorMap(const QString& columnName, ColorMapType cmap) {
     // Find the column index by name
-    for (int col = 0; col < _data.colCount(); ++col) {
-        if (_data.columnName(col) == columnName) {
+    for (int col = 0; col < _data->colCount(); ++col) {
+        if (_data->columnName(col) == columnName) {
             setColumnColorMap(col, cmap);
             break;
         }
@@ -271,9 +657,9 @@ void HighPerfTableModel::changeColorMap(const QString& columnName, ColorMapType
 }
 
 void HighPerfTableModel::changeAllNumericalColorMaps(ColorMapType cmap) {
-    for (int col = 0; col < _data.colCount(); ++col) {
-        if (_data.columnIsNumeric(col)) {
-            setColumnColorMap(col, cmap);
-        }
+    ModelTransaction transaction(*this);
+    for (int col = 0; col < _data->colCount(); ++col) {
+        if (_data->columnIsNumeric(col))
+            transaction.setColumnColorMap(col, cmap);
     }
 }
\ No newline at end of file
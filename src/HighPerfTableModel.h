@@ -2,9 +2,14 @@
 
 #include <QAbstractTableModel>
 #include <QColor>
+#include <QFutureWatcher>
 #include <functional>
 #include <map>
+#include <memory>
+#include <optional>
+#include <vector>
 #include "FastTableData.h"
+#include "RowSelection.h"
 
 // HighPerfTableModel provides a Qt model for FastTableData, supporting bar/value toggle and sorting.
 class HighPerfTableModel : public QAbstractTableModel {
@@ -37,6 +42,15 @@ public:
 
     void setData(const FastTableData& data);
 
+    // Progressive loading: append a block of rows, then replace the first rows and adopt the final column ranges.
+    void appendRows(const FastTableData& block);
+    void refineRows(int first, const FastTableData& block);
+    // Swaps in rebuilt columns of one or more source datasets, see FastTableData::replaceColumns.
+    bool replaceColumns(const FastTableData& block);
+
+    // Immutable view of the current table that worker threads can read while the model keeps changing.
+    std::shared_ptr<const FastTableData> snapshot() const;
+
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
     int columnCount(const QModelIndex& parent = QModelIndex()) const override;
     QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
@@ -57,6 +71,33 @@ public:
     void requestMoreColsLeft(int n);
     void requestMoreColsRight(int n);
 
+    bool isPaged() const;
+    // True while rows are paged in or evicted; row insertions and removals then only move the resident window.
+    bool isPaging() const;
+    int windowOffset() const;
+    int sourceRowCount() const;
+    int sourceRow(int row) const;
+    // Table row shown at view row, differs from the view row while a row filter is active.
+    int tableRow(int row) const;
+    // Selected view rows as table rows of the current snapshot.
+    RowSelection rowSelection(const QItemSelection& selection) const;
+    // View row -> table row while a row filter is active, nothing otherwise.
+    std::optional<std::vector<int>> filteredTableRows() const;
+
+    // Shows only rows whose source row is set in shownSourceRows, combined with the table's own row visibility.
+    // Updates are applied as row removals and insertions; paged tables ignore the filter.
+    void setRowFilter(std::vector<bool> shownSourceRows);
+    void clearRowFilter();
+    bool hasRowFilter() const;
+    void ensureSourceRowsResident(int first, int last);
+
+    // Lazy columns: columns [first, last] are read on a worker and show empty cells until they arrive; a request made
+    // while a read is running follows it. Sorting a column that is not resident waits for it the same way.
+    bool hasLazyColumns() const;
+    void ensureColumnsResident(int first, int last);
+    // Blocks until a column read in flight is done, it reads from the table's column source.
+    void waitForColumnLoad();
+
     void addColumn(const QString& name, const FastTableData::Value& defaultValue = FastTableData::Value{});
     bool removeColumn(const QString& name);
     void addColumns(const std::vector<QString>& names, const FastTableData::Value& defaultValue = FastTableData::Value{});
@@ -72,10 +113,33 @@ public:
     void setColumnColorMap(int col, ColorMapType cmap);
     ColorMapType columnColorMap(int col) const;
 
+signals:
+    // Lazy columns were loaded or evicted, with their ranges.
+    void lazyColumnsChanged();
+
 private:
-    FastTableData _data;
+    friend class ModelTransaction;
+
+    FastTableData& mutableTable();
+    bool isFiltering() const;
+    std::vector<int> filteredRows(int firstTableRow) const;
+    void dropColumnColorMaps(const std::vector<int>& removedColumns);
+
+    std::shared_ptr<FastTableData> _data;
     bool _showBars = false;
     QColor m_defaultClusterBgColor = Qt::white;
     std::map<int, ColorMapType> m_columnColorMaps;
+    bool _rowFilterActive = false;
+    bool _paging = false;
+    std::vector<bool> _shownSourceRows;
+    std::vector<int> _visibleRows; // view row -> table row while filtering, ascending
     QColor colorForValue(int col, float value) const;
+    void moveWindow(int firstSourceRow, int count);
+    void onColumnsLoaded();
+
+    QFutureWatcher<FastTableData::LoadedColumns> _columnLoad;
+    std::pair<int, int> _loadingColumns{ -1, -1 };
+    std::pair<int, int> _requestedColumns{ -1, -1 }; // asked for while a read was running
+    int _pendingSortColumn = -1;
+    Qt::SortOrder _pendingSortOrder = Qt::AscendingOrder;
 };
\ No newline at end of file
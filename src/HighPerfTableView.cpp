@@ -5,6 +5,7 @@
 #include "CorrelationBarDelegate.h"
 #include <QKeyEvent>
 #include <QItemSelectionModel>
+#include <QMetaMethod>
 #include <QContextMenuEvent>
 #include <QClipboard>
 #include <QApplication>
@@ -14,7 +15,22 @@
 #include <QAction>
 #include <QMenu>
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QProgressDialog>
+#include <QWheelEvent>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
 #include "TableDataUtils.h"
+#include "FileRowSource.h"
+#include "CachedRowSource.h"
+#include "TableFile.h"
+#include "TableFileSource.h"
+
+namespace {
+    // Above this scroll speed the bar delegates switch to their cheap rendering mode.
+    constexpr double kFastScrollPixelsPerSecond = 2000.0;
+}
 
 HighPerfTableView::HighPerfTableView(QWidget* parent)
     : QTableView(parent)
@@ -37,6 +53,18 @@ HighPerfTableView::HighPerfTableView(QWidget* parent)
                 this, &HighPerfTableView::onSelectionChanged);
     }
 
+    // Delegates are attached per column index, so re-attach them when columns come or go.
+    connect(_model, &QAbstractItemModel::columnsInserted, this, [this]() {
+        setBarDelegateForNumericalColumns(_model->showBars());
+    });
+    connect(_model, &QAbstractItemModel::columnsRemoved, this, [this]() {
+        setBarDelegateForNumericalColumns(_model->showBars());
+    });
+    // Lazy columns arrive with their ranges, which the bar delegates are created with.
+    connect(_model, &HighPerfTableModel::lazyColumnsChanged, this, [this]() {
+        setBarDelegateForNumericalColumns(_model->showBars());
+    });
+
     setupLazyLoading();
 }
 
@@ -44,6 +72,154 @@ void HighPerfTableView::setupSelectionMode()
 {
     setSelectionBehavior(QAbstractItemView::SelectRows);
     setSelectionMode(QAbstractItemView::ExtendedSelection);
+
+    // A drag selection changes the selection on every mouse move, the dataset only gets the result.
+    _selectionPushTimer.setSingleShot(true);
+    _selectionPushTimer.setInterval(20);
+    connect(&_selectionPushTimer, &QTimer::timeout, this, &HighPerfTableView::pushSelection);
+    connect(_model, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex&, int first, int last) {
+        if (_model->isPaging())
+            selectPagedRows(first, last);
+    });
+
+    // Imported files show their first rows right away, sorting comes back with the final ranges.
+    connect(&_importer, &TableImporter::previewReady, this, [this](const FastTableData& table) {
+        setData(table);
+        setSortingEnabled(false);
+    });
+    connect(&_importer, &TableImporter::rowsReady, this, &HighPerfTableView::appendRows);
+    connect(&_importer, &TableImporter::statsReady, this, [this](const FastTableData& firstRows) {
+        refineRows(0, firstRows);
+        setSortingEnabled(true);
+    });
+    connect(&_importer, &TableImporter::tableReady, this, &HighPerfTableView::setData);
+    connect(&_importer, &TableImporter::finished, this, [this](bool success, bool canceled) {
+        if (!success && !canceled)
+            QMessageBox::warning(this, tr("Open Failed"), tr("Failed to open table file."));
+    });
+    connect(&_fileScan, &QFutureWatcher<std::shared_ptr<FileRowSource>>::finished, this, [this]() {
+        if (!_fileScanPending || _fileScan.future().resultCount() == 0)
+            return;
+        _fileScanPending = false;
+        auto source = _fileScan.result();
+        if (!source->isValid() || source->colCount() == 0) {
+            QMessageBox::warning(this, tr("Open Failed"), tr("Failed to open table file."));
+            return;
+        }
+        FastTableData data;
+        data.setRowSource(source, _pagedWindowRows);
+        setData(data);
+    });
+}
+
+void HighPerfTableView::selectSourceRows(const std::vector<bool>& selected)
+{
+    if (!selectionModel())
+        return;
+
+    // Rows leaving the filter also leave the selection, none of it goes back to the dataset.
+    _applyingSelection = true;
+    _selectedSourceRows = selected;
+    if (_showOnlySelectedRows)
+        _model->setRowFilter(_selectedSourceRows);
+
+    const int rows = _model->rowCount();
+    const int lastColumn = std::max(_model->columnCount() - 1, 0);
+    QItemSelection selection;
+    int rangeFirst = -1;
+    for (int r = 0; r <= rows; ++r) {
+        const int sourceRow = r < rows ? _model->sourceRow(r) : -1;
+        const bool isSelected = sourceRow >= 0 && sourceRow < static_cast<int>(selected.size()) && selected[sourceRow];
+        if (isSelected && rangeFirst < 0) {
+            rangeFirst = r;
+        } else if (!isSelected && rangeFirst >= 0) {
+            selection.append(QItemSelectionRange(_model->index(rangeFirst, 0), _model->index(r - 1, lastColumn)));
+            rangeFirst = -1;
+        }
+    }
+
+    _selectionPushTimer.stop();
+    selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+    _applyingSelection = false;
+}
+
+void HighPerfTableView::selectPagedRows(int first, int last)
+{
+    if (!selectionModel() || _selectedSourceRows.empty())
+        return;
+
+    // Rows paged in take their selection from the source rows, which hold it for the whole table.
+    const int lastColumn = std::max(_model->columnCount() - 1, 0);
+    QItemSelection selection;
+    int rangeFirst = -1;
+    for (int r = first; r <= last + 1; ++r) {
+        const int sourceRow = r <= last ? _model->sourceRow(r) : -1;
+        const bool isSelected = sourceRow >= 0 && sourceRow < static_cast<int>(_selectedSourceRows.size()) && _selectedSourceRows[sourceRow];
+        if (isSelected && rangeFirst < 0) {
+            rangeFirst = r;
+        } else if (!isSelected && rangeFirst >= 0) {
+            selection.append(QItemSelectionRange(_model->index(rangeFirst, 0), _model->index(r - 1, lastColumn)));
+            rangeFirst = -1;
+        }
+    }
+    if (selection.isEmpty())
+        return;
+
+    _applyingSelection = true;
+    selectionModel()->select(selection, QItemSelectionModel::Select | QItemSelectionModel::Rows);
+    _applyingSelection = false;
+}
+
+void HighPerfTableView::pushSelection()
+{
+    if (!selectionModel())
+        return;
+
+    // Through a bitmap, so sorted tables still give ascending source rows.
+    const RowSelection selection = RowSelection::fromItemSelection(selectionModel()->selection(), nullptr);
+    std::vector<bool> selected(_model->sourceRowCount());
+    // A paged table only shows its window, the selection outside it stays as it was.
+    if (_model->isPaged() && _selectedSourceRows.size() == selected.size()) {
+        selected = _selectedSourceRows;
+        for (int r = 0; r < _model->rowCount(); ++r) {
+            const int sourceRow = _model->sourceRow(r);
+            if (sourceRow >= 0 && sourceRow < static_cast<int>(selected.size()))
+                selected[sourceRow] = false;
+        }
+    }
+    for (const auto& [first, last] : selection.ranges()) {
+        for (int r = first; r <= last; ++r) {
+            const int sourceRow = _model->sourceRow(r);
+            if (sourceRow >= 0 && sourceRow < static_cast<int>(selected.size()))
+                selected[sourceRow] = true;
+        }
+    }
+
+    std::vector<std::uint32_t> sourceRows;
+    for (std::uint32_t row = 0; row < selected.size(); ++row) {
+        if (selected[row])
+            sourceRows.push_back(row);
+    }
+    // The filter keeps showing what was selected elsewhere, narrowing the selection here does not hide rows.
+    _selectedSourceRows = std::move(selected);
+    emit sourceRowsSelected(sourceRows);
+}
+
+void HighPerfTableView::setShowOnlySelectedRows(bool enabled)
+{
+    if (_showOnlySelectedRows == enabled)
+        return;
+    _showOnlySelectedRows = enabled;
+    if (!enabled)
+        _model->clearRowFilter();
+    // Filtering resets the rows, select them again.
+    const std::vector<bool> selected = _selectedSourceRows;
+    selectSourceRows(selected);
+}
+
+bool HighPerfTableView::showOnlySelectedRows() const
+{
+    return _showOnlySelectedRows;
 }
 
 HighPerfTableModel* HighPerfTableView::model() const {
@@ -52,7 +228,43 @@ HighPerfTableModel* HighPerfTableView::model() const {
 
 void HighPerfTableView::setData(const FastTableData& data) {
     _model->setData(data);
+    setSortingEnabled(!_model->isPaged());
+    _scrollMapper.setTopPixel(0);
+    _verticalRowVelocity = 0.0;
+    _prefetcher.setCache(_model->snapshot()->rowCache());
+    if (_model->isPaged()) {
+        syncScrollBar();
+        applyLogicalScroll();
+    }
+    setBarDelegateForNumericalColumns(_model->showBars());
+    if (_model->hasLazyColumns())
+        _lazyLoadTimer.start(0);
+}
+
+void HighPerfTableView::releaseData() {
+    _prefetcher.stop();
+    _model->waitForColumnLoad();
+    _exporter.cancelAndWait();
+    _copier.cancelAndWait();
+    setData(FastTableData());
+}
+
+void HighPerfTableView::appendRows(const FastTableData& block) {
+    _model->appendRows(block);
+}
+
+void HighPerfTableView::refineRows(int first, const FastTableData& block) {
+    _model->refineRows(first, block);
+    // The bar delegates were created with the preview's column ranges.
+    setBarDelegateForNumericalColumns(_model->showBars());
+}
+
+bool HighPerfTableView::replaceColumns(const FastTableData& block) {
+    if (!_model->replaceColumns(block))
+        return false;
+    // The replaced columns come with new ranges.
     setBarDelegateForNumericalColumns(_model->showBars());
+    return true;
 }
 
 void HighPerfTableView::setBarDelegateForNumericalColumns(bool enabled)
@@ -74,6 +286,7 @@ void HighPerfTableView::setBarDelegateForNumericalColumns(bool enabled)
                 minVal, maxVal, this,
                 _showBars ? CorrelationBarDelegate::DisplayMode::Bar : CorrelationBarDelegate::DisplayMode::Number
             );
+            delegate->setFastMode(_fastRendering);
             this->setItemDelegateForColumn(col, delegate);
             _barDelegates[col] = delegate;
         }
@@ -128,6 +341,11 @@ bool HighPerfTableView::showBars() const
 
 void HighPerfTableView::keyPressEvent(QKeyEvent* event)
 {
+    if (event->matches(QKeySequence::Copy)) {
+        copySelectedRowsToClipboard();
+        event->accept();
+        return;
+    }
     if (event->key() == Qt::Key_R && !event->modifiers()) {
         selectionModel()->clearSelection();
         event->accept();
@@ -140,14 +358,30 @@ void HighPerfTableView::contextMenuEvent(QContextMenuEvent* event)
 {
     QMenu menu(this);
     QAction* copyAction = menu.addAction(tr("Copy Selected Rows"));
+    const int clickedColumn = columnAt(viewport()->mapFromGlobal(event->globalPos()).x());
+    QAction* copyColumnAction = menu.addAction(tr("Copy Selected Rows of This Column"));
+    copyColumnAction->setEnabled(clickedColumn >= 0);
     QAction* exportAction = menu.addAction(tr("Export Table..."));
+    QAction* openAction = menu.addAction(tr("Open Table File..."));
     QAction* toggleBarsAction = menu.addAction(showBars() ? tr("Show Values") : tr("Show Bars"));
+    QAction* onlySelectedAction = menu.addAction(tr("Show Only Selected Rows"));
+    onlySelectedAction->setCheckable(true);
+    onlySelectedAction->setChecked(_showOnlySelectedRows);
+    onlySelectedAction->setEnabled(!_model->isPaged());
 
     QAction* chosen = menu.exec(event->globalPos());
     if (chosen == copyAction) {
-        copySelectedRowsToClipboard(true);
+        copySelectedRowsToClipboard();
+    } else if (chosen == copyColumnAction) {
+        // The primary key goes along, so the copied values can be matched back.
+        std::vector<int> columns;
+        const int pkCol = _model->primaryKeyColumn();
+        if (pkCol >= 0 && pkCol != clickedColumn)
+            columns.push_back(pkCol);
+        columns.push_back(clickedColumn);
+        copySelectedRowsToClipboard(false, std::move(columns));
     } else if (chosen == exportAction) {
-        QString fileName = QFileDialog::getSaveFileName(this, tr("Export Table"), QString(), tr("CSV Files (*.csv);;TSV Files (*.tsv);;All Files (*)"));
+        QString fileName = QFileDialog::getSaveFileName(this, tr("Export Table"), QString(), tr("CSV Files (*.csv);;TSV Files (*.tsv);;Table Files (*.mvtab);;All Files (*)"));
         if (!fileName.isEmpty()) {
             QString format = "csv";
             if (fileName.endsWith(".tsv", Qt::CaseInsensitive)) format = "tsv";
@@ -155,68 +389,124 @@ void HighPerfTableView::contextMenuEvent(QContextMenuEvent* event)
                 QMessageBox::warning(this, tr("Export Failed"), tr("Failed to export table to file."));
             }
         }
+    } else if (chosen == openAction) {
+        QString fileName = QFileDialog::getOpenFileName(this, tr("Open Table File"), QString(), tr("CSV Files (*.csv);;TSV Files (*.tsv);;Table Files (*.mvtab);;All Files (*)"));
+        if (!fileName.isEmpty() && !openFile(fileName)) {
+            QMessageBox::warning(this, tr("Open Failed"), tr("Failed to open table file."));
+        }
     } else if (chosen == toggleBarsAction) {
         setShowBars(!showBars());
+    } else if (chosen == onlySelectedAction) {
+        setShowOnlySelectedRows(!_showOnlySelectedRows);
     }
 }
 
-void HighPerfTableView::copySelectedRowsToClipboard(bool asCsv)
+void HighPerfTableView::copySelectedRowsToClipboard(bool asCsv, std::vector<int> columns)
 {
     auto selModel = selectionModel();
-    if (!selModel) return;
-    auto selRows = selModel->selectedRows();
-    if (selRows.isEmpty()) return;
-
-    QList<int> rowIndices;
-    for (const QModelIndex& idx : selRows)
-        rowIndices << idx.row();
-
-    QString delimiter = asCsv ? "," : "\t";
-    QString text = serializeRows(rowIndices, delimiter);
+    if (!selModel || !selModel->hasSelection())
+        return;
 
-    QClipboard* clipboard = QApplication::clipboard();
-    clipboard->setText(text);
-}
+    // Rows come from the selection ranges in view order; formatting runs on worker threads.
+    std::vector<int> viewRows;
+    for (const QItemSelectionRange& range : selModel->selection()) {
+        for (int row = range.top(); row <= range.bottom(); ++row)
+            viewRows.push_back(row);
+    }
+    std::sort(viewRows.begin(), viewRows.end());
+    viewRows.erase(std::unique(viewRows.begin(), viewRows.end()), viewRows.end());
 
-QString HighPerfTableView::serializeRows(const QList<int>& rows, const QString& delimiter) const
-{
-    QStringList lines;
-    QStringList header;
-    for (int c = 0; c < _model->columnCount(); ++c)
-        header << _model->headerData(c, Qt::Horizontal, Qt::DisplayRole).toString();
-    lines << header.join(delimiter);
+    std::vector<int> rows(viewRows.size());
+    for (size_t i = 0; i < viewRows.size(); ++i)
+        rows[i] = _model->isPaged() ? _model->sourceRow(viewRows[i]) : _model->tableRow(viewRows[i]);
+    if (!_copier.start(_model->snapshot(), std::move(rows), std::move(columns), asCsv ? ',' : '\t'))
+        return;
 
-    for (int r : rows) {
-        QStringList fields;
-        for (int c = 0; c < _model->columnCount(); ++c) {
-            QVariant v = _model->data(_model->index(r, c), Qt::DisplayRole);
-            QString s = v.toString();
-            if (delimiter == "," && s.contains(',')) s = "\"" + s + "\"";
-            fields << s;
-        }
-        lines << fields.join(delimiter);
-    }
-    return lines.join("\n");
+    auto* progress = new QProgressDialog(tr("Copying %1 rows...").arg(viewRows.size()), tr("Cancel"), 0, 100, this);
+    progress->setAttribute(Qt::WA_DeleteOnClose);
+    progress->setAutoClose(false);
+    progress->setAutoReset(false);
+    progress->setMinimumDuration(500);
+    connect(progress, &QProgressDialog::canceled, &_copier, &ClipboardCopier::cancel);
+    connect(&_copier, &ClipboardCopier::progressChanged, progress, &QProgressDialog::setValue);
+    connect(&_copier, &ClipboardCopier::finished, progress, [this, progress](bool success, bool canceled, bool tooLarge) {
+        progress->close();
+        if (tooLarge)
+            QMessageBox::warning(this, tr("Copy Failed"), tr("The selection is too large for the clipboard, export it to a file instead."));
+        else if (!success && !canceled)
+            QMessageBox::warning(this, tr("Copy Failed"), tr("Failed to read the selected rows."));
+    });
 }
 
 bool HighPerfTableView::exportToFile(QWidget* parent, const QString& filePath, const QString& format)
 {
     QString outPath = filePath;
     if (outPath.isEmpty()) {
-        outPath = QFileDialog::getSaveFileName(parent ? parent : this, tr("Export Table"), QString(), tr("CSV Files (*.csv);;TSV Files (*.tsv);;All Files (*)"));
+        outPath = QFileDialog::getSaveFileName(parent ? parent : this, tr("Export Table"), QString(), tr("CSV Files (*.csv);;TSV Files (*.tsv);;Table Files (*.mvtab);;All Files (*)"));
         if (outPath.isEmpty()) return false;
     }
-    QString delimiter = (format == "tsv" || outPath.endsWith(".tsv", Qt::CaseInsensitive)) ? "\t" : ",";
-    QList<int> allRows;
-    for (int r = 0; r < _model->rowCount(); ++r) allRows << r;
-    QString text = serializeRows(allRows, delimiter);
-
-    QFile file(outPath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    const char delimiter = (format == "tsv" || outPath.endsWith(".tsv", Qt::CaseInsensitive)) ? '\t' : ',';
+
+    // A filtered view exports the rows it shows.
+    std::vector<int> rows;
+    if (_model->hasRowFilter()) {
+        rows.reserve(_model->rowCount());
+        for (int r = 0; r < _model->rowCount(); ++r)
+            rows.push_back(_model->tableRow(r));
+    }
+    if (!_exporter.start(_model->snapshot(), outPath, delimiter, std::move(rows)))
         return false;
-    QTextStream ts(&file);
-    ts << text;
-    file.close();
+
+    auto* progress = new QProgressDialog(tr("Exporting %1...").arg(QFileInfo(outPath).fileName()), tr("Cancel"), 0, 100, parent ? parent : this);
+    progress->setAttribute(Qt::WA_DeleteOnClose);
+    progress->setAutoClose(false);
+    progress->setAutoReset(false);
+    progress->setMinimumDuration(500);
+    connect(progress, &QProgressDialog::canceled, &_exporter, &TableExporter::cancel);
+    connect(&_exporter, &TableExporter::progressChanged, progress, &QProgressDialog::setValue);
+    connect(&_exporter, &TableExporter::finished, progress, [this, progress](bool success, bool canceled) {
+        progress->close();
+        if (!success && !canceled)
+            QMessageBox::warning(this, tr("Export Failed"), tr("Failed to export table to file."));
+    });
+    return true;
+}
+
+bool HighPerfTableView::openFile(const QString& filePath)
+{
+    _importer.cancel();
+    // A scan still running cannot be stopped, its result is dropped instead.
+    _fileScanPending = false;
+
+    // Table files are mapped and their columns materialized as they scroll into view.
+    if (TableFile::isTableFile(filePath)) {
+        auto tableFile = std::make_shared<TableFileSource>(filePath);
+        if (!tableFile->isValid() || tableFile->colCount() == 0)
+            return false;
+
+        FastTableData data;
+        data.setColumnSource(tableFile, _lazyResidentCells);
+        if (tableFile->primaryKeyColumn() >= 0)
+            data.setPrimaryKeyColumn(tableFile->primaryKeyColumn());
+        emit fileOpened(filePath);
+        setData(data);
+        return true;
+    }
+
+    // Text files that fit in memory are imported in parallel, larger ones are paged from disk.
+    if (QFileInfo(filePath).size() <= _importMaxBytes) {
+        if (!_importer.start(filePath))
+            return false;
+        emit fileOpened(filePath);
+        return true;
+    }
+
+    // Indexing reads the whole file, so it runs on a worker and the table is shown when it is done.
+    emit fileOpened(filePath);
+    _fileScanPending = true;
+    _fileScan.setFuture(QtConcurrent::run([filePath]() {
+        return std::make_shared<FileRowSource>(filePath);
+    }));
     return true;
 }
 
@@ -224,19 +514,32 @@ void HighPerfTableView::onSelectionChanged(const QItemSelection&, const QItemSel
 {
     auto selModel = selectionModel();
     if (!selModel) return;
-    auto selRows = selModel->selectedRows();
+    // Paging moves rows in and out of the window, that is no change of the selection.
+    if (!_applyingSelection && !_model->isPaging())
+        _selectionPushTimer.start();
+
+    emit selectionRangesChanged(_model->rowSelection(selModel->selection()));
+
+    if (!isSignalConnected(QMetaMethod::fromSignal(&HighPerfTableView::selectionChangedWithValues)))
+        return;
+
+    // Read through the model, so view rows are fine here.
+    const RowSelection selection = RowSelection::fromItemSelection(selModel->selection(), nullptr);
     QList<QVariantList> selectedValues;
+    selectedValues.reserve(selection.rowCount());
 
     int firstCol = 0;
     int pkCol = _model->primaryKeyColumn();
 
-    for (const QModelIndex& idx : selRows) {
-        QVariantList rowValues;
-        rowValues << _model->data(_model->index(idx.row(), firstCol), Qt::DisplayRole);
-        if (pkCol != -1 && pkCol != firstCol) {
-            rowValues << _model->data(_model->index(idx.row(), pkCol), Qt::DisplayRole);
+    for (const auto& [first, last] : selection.ranges()) {
+        for (int row = first; row <= last; ++row) {
+            QVariantList rowValues;
+            rowValues << _model->data(_model->index(row, firstCol), Qt::DisplayRole);
+            if (pkCol != -1 && pkCol != firstCol) {
+                rowValues << _model->data(_model->index(row, pkCol), Qt::DisplayRole);
+            }
+            selectedValues << rowValues;
         }
-        selectedValues << rowValues;
     }
     emit selectionChangedWithValues(selectedValues);
 }
@@ -244,30 +547,83 @@ void HighPerfTableView::onSelectionChanged(const QItemSelection&, const QItemSel
 void HighPerfTableView::setupLazyLoading()
 {
     connect(verticalScrollBar(), &QScrollBar::valueChanged, this, [this](int) {
+        trackScrollVelocity();
         _lazyLoadTimer.start(50);
     });
     connect(horizontalScrollBar(), &QScrollBar::valueChanged, this, [this](int) {
+        trackScrollVelocity();
         _lazyLoadTimer.start(50);
     });
     _lazyLoadTimer.setSingleShot(true);
     connect(&_lazyLoadTimer, &QTimer::timeout, this, [this]() {
         handleVerticalScroll();
         handleHorizontalScroll();
+        // Scrolling settled, repaint once at full quality.
+        _scrollVelocity = 0.0;
+        setFastRendering(false);
     });
 }
 
+void HighPerfTableView::trackScrollVelocity()
+{
+    const bool paged = _model && _model->isPaged();
+    const qint64 verticalPosition = paged ? _scrollMapper.topPixel() : verticalScrollBar()->value();
+    const qint64 position = verticalPosition + horizontalScrollBar()->value();
+    if (!_scrollClock.isValid()) {
+        _scrollClock.start();
+        _lastScrollPosition = position;
+        _lastVerticalPosition = verticalPosition;
+        return;
+    }
+
+    const qint64 elapsedMs = std::max<qint64>(_scrollClock.restart(), 1);
+    const double instant = std::abs(position - _lastScrollPosition) * 1000.0 / elapsedMs;
+    const double verticalRows = static_cast<double>(verticalPosition - _lastVerticalPosition) / verticalHeader()->defaultSectionSize();
+    _lastScrollPosition = position;
+    _lastVerticalPosition = verticalPosition;
+    _scrollVelocity = 0.5 * _scrollVelocity + 0.5 * instant;
+    _verticalRowVelocity = 0.5 * _verticalRowVelocity + 0.5 * verticalRows * 1000.0 / elapsedMs;
+
+    setFastRendering(_scrollVelocity > kFastScrollPixelsPerSecond);
+
+    if (paged) {
+        const int visibleRows = viewport()->height() / verticalHeader()->defaultSectionSize() + 1;
+        _prefetcher.update(static_cast<int>(_scrollMapper.topRow()), visibleRows, _verticalRowVelocity);
+    }
+}
+
+void HighPerfTableView::setFastRendering(bool fast)
+{
+    if (_fastRendering == fast)
+        return;
+    _fastRendering = fast;
+    for (auto* delegate : _barDelegates)
+        delegate->setFastMode(fast);
+    if (!fast)
+        viewport()->update();
+}
+
 void HighPerfTableView::handleVerticalScroll()
 {
+    if (_model->isPaged()) {
+        // The visible rows are already resident, top up a margin on both sides once scrolling settles.
+        const int topRow = static_cast<int>(_scrollMapper.topRow());
+        const int visibleRows = viewport()->height() / verticalHeader()->defaultSectionSize() + 1;
+        _model->ensureSourceRowsResident(topRow - _lazyLoadPageRows, topRow + visibleRows + _lazyLoadPageRows);
+        applyLogicalScroll();
+        return;
+    }
+
     int firstVisible = rowAt(0);
     int lastVisible = rowAt(viewport()->height() - 1);
     if (firstVisible < 0 || lastVisible < 0) return;
 
     int totalRows = _model->rowCount();
     if (firstVisible < _lazyLoadThresholdRows) {
-        _model->requestMoreRowsTop(_lazyLoadThresholdRows);
+        _model->requestMoreRowsTop(_lazyLoadPageRows);
     }
     if (lastVisible > totalRows - _lazyLoadThresholdRows) {
-        _model->requestMoreRowsBottom(_lazyLoadThresholdRows);
+        _model->requestMoreRowsBottom(_lazyLoadPageRows);
     }
 }
 
@@ -275,7 +631,11 @@ void HighPerfTableView::handleHorizontalScroll()
 {
     int firstVisible = columnAt(0);
     int lastVisible = columnAt(viewport()->width() - 1);
-    if (firstVisible < 0 || lastVisible < 0) return;
+    if (firstVisible < 0) return;
+    if (lastVisible < 0) lastVisible = _model->columnCount() - 1;
+
+    // Lazy columns are read in the background once they scroll into view.
+    _model->ensureColumnsResident(firstVisible, lastVisible);
 
     int totalCols = _model->columnCount();
     if (firstVisible < _lazyLoadThresholdCols) {
@@ -300,6 +660,163 @@ bool HighPerfTableView::removeColumn(const QString& name) {
     return false;
 }
 
+std::pair<int, int> HighPerfTableView::visibleSourceRows() const
+{
+    if (_model->isPaged()) {
+        const int top = static_cast<int>(_scrollMapper.topRow());
+        const int visibleRows = viewport()->height() / verticalHeader()->defaultSectionSize();
+        return { top, std::min(_model->sourceRowCount() - 1, top + visibleRows) };
+    }
+
+    int first = rowAt(0);
+    int last = rowAt(viewport()->height() - 1);
+    if (first < 0) first = 0;
+    if (last < 0) last = _model->rowCount() - 1;
+    return { first, last };
+}
+
+std::pair<int, int> HighPerfTableView::visibleColumns() const
+{
+    int first = columnAt(0);
+    int last = columnAt(viewport()->width() - 1);
+    if (first < 0) first = 0;
+    if (last < 0) last = _model->columnCount() - 1;
+    return { first, last };
+}
+
+void HighPerfTableView::scrollToSourcePosition(int sourceRow, int column)
+{
+    if (column >= 0 && column < _model->columnCount())
+        horizontalScrollBar()->setValue(horizontalHeader()->sectionPosition(column) - viewport()->width() / 2);
+
+    const int rowHeight = verticalHeader()->defaultSectionSize();
+    if (_model->isPaged()) {
+        _scrollMapper.setTopPixel(static_cast<qint64>(sourceRow) * rowHeight - viewport()->height() / 2);
+        syncScrollBar();
+        applyLogicalScroll();
+    } else if (sourceRow >= 0 && sourceRow < _model->rowCount()) {
+        verticalScrollBar()->setValue(verticalHeader()->sectionPosition(sourceRow) - viewport()->height() / 2);
+    }
+}
+
+void HighPerfTableView::updateGeometries()
+{
+    _syncingScrollBar = true;
+    QTableView::updateGeometries();
+    _syncingScrollBar = false;
+
+    if (_model && _model->isPaged()) {
+        syncScrollBar();
+        applyLogicalScroll();
+    }
+    // A wider viewport can uncover lazy columns without any scrolling.
+    if (_model && _model->hasLazyColumns() && !_lazyLoadTimer.isActive())
+        _lazyLoadTimer.start(50);
+}
+
+void HighPerfTableView::scrollContentsBy(int dx, int dy)
+{
+    if (!_model || !_model->isPaged()) {
+        QTableView::scrollContentsBy(dx, dy);
+        return;
+    }
+
+    if (dx != 0)
+        QTableView::scrollContentsBy(dx, 0);
+    if (dy != 0 && !_syncingScrollBar) {
+        _scrollMapper.setScrollBarValue(verticalScrollBar()->value());
+        applyLogicalScroll();
+    }
+}
+
+void HighPerfTableView::wheelEvent(QWheelEvent* event)
+{
+    const QPoint pixelDelta = event->pixelDelta();
+    const QPoint angleDelta = event->angleDelta();
+    if (!_model || !_model->isPaged() || (pixelDelta.y() == 0 && angleDelta.y() == 0) || (event->modifiers() & Qt::ShiftModifier)) {
+        QTableView::wheelEvent(event);
+        return;
+    }
+
+    const int rowHeight = verticalHeader()->defaultSectionSize();
+    const qint64 delta = pixelDelta.y() != 0
+        ? -pixelDelta.y()
+        : -static_cast<qint64>(angleDelta.y()) * QApplication::wheelScrollLines() * rowHeight / 120;
+    _scrollMapper.scrollByPixels(delta);
+    syncScrollBar();
+    applyLogicalScroll();
+    event->accept();
+}
+
+void HighPerfTableView::scrollTo(const QModelIndex& index, ScrollHint hint)
+{
+    if (!_model || !_model->isPaged() || !index.isValid()) {
+        QTableView::scrollTo(index, hint);
+        return;
+    }
+
+    // Let the base class handle the horizontal part, the vertical position is resolved in source rows.
+    _syncingScrollBar = true;
+    QTableView::scrollTo(index, hint);
+    _syncingScrollBar = false;
+
+    const int rowHeight = verticalHeader()->defaultSectionSize();
+    const int viewportHeight = viewport()->height();
+    const qint64 rowTop = static_cast<qint64>(_model->windowOffset() + index.row()) * rowHeight;
+    const qint64 top = _scrollMapper.topPixel();
+    qint64 newTop = top;
+    switch (hint) {
+    case PositionAtTop:
+        newTop = rowTop;
+        break;
+    case PositionAtBottom:
+        newTop = rowTop + rowHeight - viewportHeight;
+        break;
+    case PositionAtCenter:
+        newTop = rowTop + rowHeight / 2 - viewportHeight / 2;
+        break;
+    default:
+        if (rowTop < top)
+            newTop = rowTop;
+        else if (rowTop + rowHeight > top + viewportHeight)
+            newTop = rowTop + rowHeight - viewportHeight;
+        break;
+    }
+    _scrollMapper.setTopPixel(newTop);
+    syncScrollBar();
+    applyLogicalScroll();
+}
+
+void HighPerfTableView::syncScrollBar()
+{
+    _scrollMapper.setGeometry(_model->sourceRowCount(), verticalHeader()->defaultSectionSize(), viewport()->height());
+
+    QScrollBar* bar = verticalScrollBar();
+    _syncingScrollBar = true;
+    bar->setRange(0, _scrollMapper.scrollBarMaximum());
+    bar->setPageStep(_scrollMapper.scrollBarPageStep());
+    bar->setSingleStep(std::max(1, _scrollMapper.scrollBarPageStep() / 20));
+    bar->setValue(_scrollMapper.scrollBarValue());
+    _syncingScrollBar = false;
+}
+
+void HighPerfTableView::applyLogicalScroll()
+{
+    // Paging rows in or out can relayout the view, which must not re-enter here.
+    if (_applyingScroll)
+        return;
+    _applyingScroll = true;
+
+    const int rowHeight = verticalHeader()->defaultSectionSize();
+    const int topRow = static_cast<int>(_scrollMapper.topRow());
+    const int visibleRows = viewport()->height() / rowHeight + 2;
+    _model->ensureSourceRowsResident(topRow, topRow + visibleRows);
+
+    verticalHeader()->setOffset((topRow - _model->windowOffset()) * rowHeight + _scrollMapper.topRowPixelOffset());
+    viewport()->update();
+    _applyingScroll = false;
+}
+
 QColor HighPerfTableView::currentTableBackgroundColor() const
 {
     return palette().color(QPalette::Base);
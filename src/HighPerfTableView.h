@@ -4,6 +4,8 @@
 #include <QAbstractTableModel>
 #include <memory>
 #include <vector>
+#include <cstdint>
+#include <utility>
 #include <QMap>
 #include <QKeyEvent>
 #include <QMenu>
@@ -14,10 +16,19 @@
 #include <QVariant>
 #include <QTimer>
 #include <QColor>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
 #include "CorrelationBarDelegate.h"
 #include "FastTableData.h"
 #include "HighPerfTableModel.h"
 #include "TableDataUtils.h"
+#include "ScrollMapper.h"
+#include "RowPrefetcher.h"
+#include "RowSelection.h"
+#include "TableExporter.h"
+#include "TableImporter.h"
+#include "FileRowSource.h"
+#include "ClipboardCopier.h"
 
 // HighPerfTableView is a QTableView for FastTableData, supporting bar/value toggle, sorting, selection, and export.
 class HighPerfTableView : public QTableView {
@@ -27,6 +38,11 @@ public:
 
     HighPerfTableModel* model() const;
     void setData(const FastTableData& data);
+    // Clears the table once every background reader of it (prefetch, column reads, export, copy) has stopped.
+    void releaseData();
+    void appendRows(const FastTableData& block);
+    void refineRows(int first, const FastTableData& block);
+    bool replaceColumns(const FastTableData& block);
 
     void setBarDelegateForNumericalColumns(bool enabled);
     void setBarDelegateForColumn(int column, bool enabled, float minValue = -1.0f, float maxValue = 1.0f);
@@ -35,19 +51,45 @@ public:
     bool showBars() const;
     void setBarDelegateDisplayMode(bool showBars);
 
+    // Starts a background export with a progress dialog; false when no export could be started.
     bool exportToFile(QWidget* parent = nullptr, const QString& filePath = QString(), const QString& format = "csv");
+    // Opens a table or text file; large text files are indexed in the background and shown once that is done.
+    bool openFile(const QString& filePath);
 
     void addColumn(const QString& name, const FastTableData::Value& defaultValue = FastTableData::Value{});
     bool removeColumn(const QString& name);
 
     QColor currentTableBackgroundColor() const;
 
+    std::pair<int, int> visibleSourceRows() const;
+    std::pair<int, int> visibleColumns() const;
+    void scrollToSourcePosition(int sourceRow, int column);
+
+    // Selection linking in source-row space, independent of sorting and paging.
+    // Selects the rows whose source row is set in selected, merged into row ranges; does not echo back.
+    void selectSourceRows(const std::vector<bool>& selected);
+    // Shows only the rows selected in the dataset, following later incoming selection changes.
+    void setShowOnlySelectedRows(bool enabled);
+    bool showOnlySelectedRows() const;
+
 signals:
+    // Per-row values of the first and primary key column; only built while something is connected.
     void selectionChangedWithValues(const QList<QVariantList>& selectedValues);
+    void selectionRangesChanged(const RowSelection& selection);
+    // Debounced: the selected source rows, ascending, after the user changed the selection.
+    void sourceRowsSelected(const std::vector<std::uint32_t>& sourceRows);
+    // The table is about to be replaced by the contents of a file, it no longer shows a dataset.
+    void fileOpened(const QString& filePath);
+
+public:
+    void scrollTo(const QModelIndex& index, ScrollHint hint = EnsureVisible) override;
 
 protected:
     void keyPressEvent(QKeyEvent* event) override;
     void contextMenuEvent(QContextMenuEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void updateGeometries() override;
 
 private slots:
     void onSelectionChanged(const QItemSelection& selected, const QItemSelection& deselected);
@@ -57,15 +99,48 @@ private:
     QMap<int, CorrelationBarDelegate*> _barDelegates;
 
     void setupSelectionMode();
-    void copySelectedRowsToClipboard(bool asCsv = false);
-    QString serializeRows(const QList<int>& rows, const QString& delimiter) const;
+    void pushSelection();
+    void selectPagedRows(int first, int last);
+    QTimer _selectionPushTimer;
+    bool _applyingSelection = false;
+    bool _showOnlySelectedRows = false;
+    TableExporter _exporter;
+    TableImporter _importer;
+    qint64 _importMaxBytes = qint64(4) * 1024 * 1024 * 1024;
+    QFutureWatcher<std::shared_ptr<FileRowSource>> _fileScan;
+    bool _fileScanPending = false;
+    std::vector<bool> _selectedSourceRows; // dataset selection as last exchanged, by source row
+    // Copies the selected rows, of the given columns or all, in the background.
+    void copySelectedRowsToClipboard(bool asCsv = false, std::vector<int> columns = {});
+    ClipboardCopier _copier;
 
     bool _showBars = true;
 
     void setupLazyLoading();
     void handleVerticalScroll();
     void handleHorizontalScroll();
+    void trackScrollVelocity();
+    void setFastRendering(bool fast);
     QTimer _lazyLoadTimer;
     int _lazyLoadThresholdRows = 100;
+    int _lazyLoadPageRows = 2000;
+    int _pagedWindowRows = 20000;
+    qint64 _lazyResidentCells = 20000000;
     int _lazyLoadThresholdCols = 10;
+
+    // Paged tables scroll over all source rows through the mapper, the vertical scrollbar only reflects it.
+    void syncScrollBar();
+    void applyLogicalScroll();
+    ScrollMapper _scrollMapper;
+    bool _syncingScrollBar = false;
+    bool _applyingScroll = false;
+
+    // Scroll speed in pixels per second, smoothed, drives the reduced-fidelity rendering.
+    QElapsedTimer _scrollClock;
+    qint64 _lastScrollPosition = 0;
+    qint64 _lastVerticalPosition = 0;
+    double _scrollVelocity = 0.0;
+    double _verticalRowVelocity = 0.0;
+    RowPrefetcher _prefetcher;
+    bool _fastRendering = false;
 };
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "ModelTransaction.h"
+#include <algorithm>
+#include <limits>
+
+ModelTransaction::ModelTransaction(HighPerfTableModel& model)
+    : _model(model)
+{}
+
+ModelTransaction::~ModelTransaction()
+{
+    commit();
+}
+
+void ModelTransaction::addColumn(const QString& name, const FastTableData::Value& defaultValue)
+{
+    _addedColumns.emplace_back(name, defaultValue);
+}
+
+void ModelTransaction::removeColumn(const QString& name)
+{
+    _removedColumns.push_back(name);
+}
+
+void ModelTransaction::setColumnColorMap(int col, HighPerfTableModel::ColorMapType cmap)
+{
+    _colorMaps[col] = cmap;
+}
+
+void ModelTransaction::setValue(int row, int col, const FastTableData::Value& value)
+{
+    _edits.emplace_back(row, col, value);
+}
+
+void ModelTransaction::commit()
+{
+    auto& model = _model;
+
+    std::vector<int> removed;
+    for (const auto& name : _removedColumns) {
+        const int col = model._data->columnIndex(name);
+        if (col >= 0)
+            removed.push_back(col);
+    }
+    std::sort(removed.begin(), removed.end());
+    removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+
+    // One removal per contiguous run, last run first so the earlier runs keep their indices.
+    // The model has to match the view after every endRemoveColumns, so each run is compacted as it is announced.
+    for (size_t end = removed.size(); end > 0;) {
+        size_t begin = end - 1;
+        while (begin > 0 && removed[begin - 1] == removed[begin] - 1)
+            --begin;
+        const std::vector<int> run(removed.begin() + begin, removed.begin() + end);
+        model.beginRemoveColumns(QModelIndex(), run.front(), run.back());
+        model.mutableTable().removeColumns(run);
+        model.dropColumnColorMaps(run);
+        model.endRemoveColumns();
+        end = begin;
+    }
+
+    if (!_addedColumns.empty()) {
+        const int first = model.columnCount();
+        model.beginInsertColumns(QModelIndex(), first, first + static_cast<int>(_addedColumns.size()) - 1);
+        model.mutableTable().addColumns(_addedColumns);
+        model.endInsertColumns();
+    }
+
+    // Colormap changes and value edits share one dataChanged over their bounding rectangle.
+    const int rows = model.rowCount();
+    const int cols = model.columnCount();
+    int top = std::numeric_limits<int>::max(), left = std::numeric_limits<int>::max();
+    int bottom = -1, right = -1;
+
+    for (const auto& [col, cmap] : _colorMaps) {
+        if (col < 0 || col >= cols)
+            continue;
+        model.m_columnColorMaps[col] = cmap;
+        if (rows > 0) {
+            top = 0;
+            bottom = rows - 1;
+            left = std::min(left, col);
+            right = std::max(right, col);
+        }
+    }
+
+    bool edited = false;
+    for (const auto& [row, col, value] : _edits) {
+        if (row < 0 || row >= rows || col < 0 || col >= cols)
+            continue;
+        model.mutableTable().set(model.tableRow(row), col, value);
+        edited = true;
+        top = std::min(top, row);
+        bottom = std::max(bottom, row);
+        left = std::min(left, col);
+        right = std::max(right, col);
+    }
+
+    if (bottom >= 0 && right >= 0) {
+        const QList<int> roles = edited ? QList<int>{} : QList<int>{ Qt::BackgroundRole };
+        emit model.dataChanged(model.index(top, left), model.index(bottom, right), roles);
+    }
+
+    _addedColumns.clear();
+    _removedColumns.clear();
+    _colorMaps.clear();
+    _edits.clear();
+}
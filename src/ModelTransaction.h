@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QString>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "FastTableData.h"
+#include "HighPerfTableModel.h"
+
+// Scoped batch of edits to a HighPerfTableModel: storage is compacted once and views get one notification per kind of change.
+// Column indices passed to setColumnColorMap/setValue refer to the layout after the queued removals and additions.
+class ModelTransaction {
+public:
+    explicit ModelTransaction(HighPerfTableModel& model);
+    ~ModelTransaction();
+
+    ModelTransaction(const ModelTransaction&) = delete;
+    ModelTransaction& operator=(const ModelTransaction&) = delete;
+
+    void addColumn(const QString& name, const FastTableData::Value& defaultValue = FastTableData::Value{});
+    void removeColumn(const QString& name);
+    void setColumnColorMap(int col, HighPerfTableModel::ColorMapType cmap);
+    void setValue(int row, int col, const FastTableData::Value& value);
+
+    // Applies everything queued so far; called by the destructor if not done explicitly.
+    void commit();
+
+private:
+    HighPerfTableModel& _model;
+    std::vector<std::pair<QString, FastTableData::Value>> _addedColumns;
+    std::vector<QString> _removedColumns;
+    std::map<int, HighPerfTableModel::ColorMapType> _colorMaps;
+    std::vector<std::tuple<int, int, FastTableData::Value>> _edits;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// bfloat16 kept as its raw bits, the upper half of an IEEE single.
+struct BFloat16 {
+    std::uint16_t bits = 0;
+
+    static BFloat16 fromFloat(float value) {
+        std::uint32_t floatBits;
+        std::memcpy(&floatBits, &value, sizeof(floatBits));
+        return { static_cast<std::uint16_t>(floatBits >> 16) };
+    }
+
+    operator float() const {
+        const std::uint32_t floatBits = static_cast<std::uint32_t>(bits) << 16;
+        float value;
+        std::memcpy(&value, &floatBits, sizeof(value));
+        return value;
+    }
+};
+
+// Numeric column values in the element type of their source, so memory matches the source dataset.
+using NumericBuffer = std::variant<
+    std::vector<float>,
+    std::vector<double>,
+    std::vector<std::int32_t>,
+    std::vector<std::int16_t>,
+    std::vector<std::uint16_t>,
+    std::vector<std::int8_t>,
+    std::vector<std::uint8_t>,
+    std::vector<BFloat16>>;
+
+// Kernels instantiated per element type, so every pass runs on the narrowest type.
+namespace NumericKernels {
+
+template <typename T>
+using Arithmetic = std::conditional_t<std::is_same_v<T, BFloat16>, float, T>;
+
+template <typename T>
+std::pair<double, double> range(const std::vector<T>& values)
+{
+    if (values.empty())
+        return { 0.0, 0.0 };
+    Arithmetic<T> minVal = values.front(), maxVal = values.front();
+    for (const Arithmetic<T> value : values) {
+        minVal = std::min(minVal, value);
+        maxVal = std::max(maxVal, value);
+    }
+    return { static_cast<double>(minVal), static_cast<double>(maxVal) };
+}
+
+// Stable order of rows by value; order[newRow] = oldRow.
+template <typename T>
+void sortRows(std::vector<int>& order, const std::vector<T>& values, bool ascending)
+{
+    if (ascending)
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return Arithmetic<T>(values[a]) < Arithmetic<T>(values[b]); });
+    else
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return Arithmetic<T>(values[b]) < Arithmetic<T>(values[a]); });
+}
+
+inline size_t size(const NumericBuffer& buffer)
+{
+    return std::visit([](const auto& values) { return values.size(); }, buffer);
+}
+
+inline size_t bytes(const NumericBuffer& buffer)
+{
+    return std::visit([](const auto& values) { return values.size() * sizeof(values.front()); }, buffer);
+}
+
+}
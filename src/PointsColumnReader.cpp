@@ -0,0 +1,75 @@
+#include "PointsColumnReader.h"
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <type_traits>
+
+namespace {
+    // Rows per parallel task; each task reads its rows once and scatters them over the column buffers.
+    constexpr int kTileRows = 4096;
+
+    std::vector<int> rowTiles(int count) {
+        std::vector<int> tiles;
+        for (int r = 0; r < count; r += kTileRows)
+            tiles.push_back(r);
+        return tiles;
+    }
+}
+
+std::vector<std::uint32_t> rawRowIndices(const mv::Dataset<Points>& points, int first, int count)
+{
+    std::vector<std::uint32_t> indices(count);
+    if (points->isFull())
+        std::iota(indices.begin(), indices.end(), static_cast<std::uint32_t>(first));
+    else
+        std::copy_n(points->indices.begin() + first, count, indices.begin());
+    return indices;
+}
+
+std::vector<NumericBuffer> readNativeColumns(const mv::Dataset<Points>& points, const std::vector<int>& dimensions, int first, int count)
+{
+    const size_t dims = dimensions.size();
+    std::vector<NumericBuffer> columns(dims);
+    const auto tiles = rowTiles(count);
+
+    if (!points->isFull() || points->isDerivedData()) {
+        std::vector<float> block(static_cast<size_t>(count) * dims);
+        points->populateDataForDimensions(block, dimensions, rawRowIndices(points, first, count));
+
+        std::vector<std::vector<float>> typed(dims, std::vector<float>(count));
+        QtConcurrent::blockingMap(tiles, [&](int tileFirst) {
+            const int tileEnd = std::min(tileFirst + kTileRows, count);
+            for (int r = tileFirst; r < tileEnd; ++r) {
+                for (size_t d = 0; d < dims; ++d)
+                    typed[d][r] = block[static_cast<size_t>(r) * dims + d];
+            }
+        });
+        for (size_t d = 0; d < dims; ++d)
+            columns[d] = std::move(typed[d]);
+        return columns;
+    }
+
+    const size_t stride = points->getNumDimensions();
+    points->constVisitFromBeginToEnd([&](auto begin, auto) {
+        using Source = std::decay_t<decltype(*begin)>;
+        using Stored = std::conditional_t<std::is_same_v<Source, biovault::bfloat16_t>, BFloat16, Source>;
+
+        std::vector<std::vector<Stored>> typed(dims, std::vector<Stored>(count));
+        QtConcurrent::blockingMap(tiles, [&](int tileFirst) {
+            const int tileEnd = std::min(tileFirst + kTileRows, count);
+            for (int r = tileFirst; r < tileEnd; ++r) {
+                const auto row = begin + static_cast<std::ptrdiff_t>((static_cast<size_t>(first) + r) * stride);
+                for (size_t d = 0; d < dims; ++d) {
+                    if constexpr (std::is_same_v<Source, biovault::bfloat16_t>)
+                        typed[d][r] = BFloat16::fromFloat(static_cast<float>(row[dimensions[d]]));
+                    else
+                        typed[d][r] = row[dimensions[d]];
+                }
+            }
+        });
+        for (size_t d = 0; d < dims; ++d)
+            columns[d] = std::move(typed[d]);
+    });
+    return columns;
+}
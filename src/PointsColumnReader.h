@@ -0,0 +1,14 @@
+#pragma once
+
+#include <Dataset.h>
+#include <PointData/PointData.h>
+#include <cstdint>
+#include <vector>
+#include "NumericColumn.h"
+
+// Reads rows [first, first + count) of the given dimensions of a Points dataset, one buffer per dimension in the
+// dataset's own element type. Subsets and derived datasets are read as float through populateDataForDimensions.
+std::vector<NumericBuffer> readNativeColumns(const mv::Dataset<Points>& points, const std::vector<int>& dimensions, int first, int count);
+
+// Raw data indices of the local rows [first, first + count); subsets keep their points in points->indices.
+std::vector<std::uint32_t> rawRowIndices(const mv::Dataset<Points>& points, int first, int count);
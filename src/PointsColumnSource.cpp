@@ -0,0 +1,122 @@
+#include "PointsColumnSource.h"
+#include "PointsColumnReader.h"
+#include <cstdint>
+
+PointsColumnSource::PointsColumnSource(const mv::Dataset<Points>& points)
+{
+    if (!points.isValid())
+        return;
+
+    _rows = static_cast<int>(points->getNumPoints());
+    addDataset(points);
+
+    auto children = points->getChildren();
+    for (const mv::Dataset<Points>& child : children) {
+        if (child->getDataType() == PointType && static_cast<int>(child->getNumPoints()) == _rows && child->getNumDimensions() > 0)
+            addDataset(child);
+    }
+    for (const mv::Dataset<Clusters>& child : children) {
+        if (child->getDataType() == ClusterType)
+            addClusterColumn(child);
+    }
+}
+
+void PointsColumnSource::addDataset(const mv::Dataset<Points>& dataset)
+{
+    const int datasetIndex = static_cast<int>(_datasets.size());
+    _datasets.push_back(dataset);
+
+    const auto names = dataset->getDimensionNames();
+    const int numDims = static_cast<int>(dataset->getNumDimensions());
+    for (int d = 0; d < numDims; ++d) {
+        const QString name = d < static_cast<int>(names.size()) ? names[d] : QString();
+        _columns.push_back({ name.isEmpty() ? QString("Dimension %1").arg(colCount() + 1) : name, datasetIndex, d, -1 });
+    }
+}
+
+void PointsColumnSource::addClusterColumn(const mv::Dataset<Clusters>& clusters)
+{
+    _columns.push_back({ clusters->getGuiName(), -1, 0, static_cast<int>(_clusterColumns.size()) });
+    _clusterColumns.push_back(ClusterCodes::fromClusters(clusters, _rows));
+}
+
+QString PointsColumnSource::columnName(int col) const
+{
+    if (col >= 0 && col < colCount()) return _columns[col].name;
+    return {};
+}
+
+bool PointsColumnSource::columnIsNumeric(int col) const
+{
+    if (col >= 0 && col < colCount()) return _columns[col].cluster < 0;
+    return true;
+}
+
+std::map<QString, QColor> PointsColumnSource::columnLabelColors(int col) const
+{
+    if (col >= 0 && col < colCount() && _columns[col].cluster >= 0)
+        return _clusterColumns[_columns[col].cluster].colors;
+    return {};
+}
+
+bool PointsColumnSource::readColumn(int col, std::vector<FastTableData::Value>& out) const
+{
+    if (col < 0 || col >= colCount())
+        return false;
+
+    const auto& ref = _columns[col];
+    out.resize(_rows);
+
+    if (ref.cluster >= 0) {
+        const auto& cluster = _clusterColumns[ref.cluster];
+        for (int r = 0; r < _rows; ++r)
+            out[r] = cluster.label(r);
+        return true;
+    }
+
+    std::vector<float> values(_rows);
+    _datasets[ref.dataset]->populateDataForDimensions(values, std::vector<int>{ ref.dimension });
+    for (int r = 0; r < _rows; ++r)
+        out[r] = static_cast<double>(values[r]);
+    return true;
+}
+
+bool PointsColumnSource::readNumericColumn(int col, NumericBuffer& out) const
+{
+    if (col < 0 || col >= colCount() || _columns[col].cluster >= 0)
+        return false;
+
+    const auto& ref = _columns[col];
+    auto columns = readNativeColumns(_datasets[ref.dataset], { ref.dimension }, 0, _rows);
+    out = std::move(columns.front());
+    return true;
+}
+
+bool PointsColumnSource::readColumnRows(int col, const std::vector<int>& rows, std::vector<FastTableData::Value>& out) const
+{
+    if (col < 0 || col >= colCount())
+        return false;
+
+    const auto& ref = _columns[col];
+    out.resize(rows.size());
+
+    if (ref.cluster >= 0) {
+        const auto& cluster = _clusterColumns[ref.cluster];
+        for (size_t i = 0; i < rows.size(); ++i)
+            out[i] = cluster.label(rows[i]);
+        return true;
+    }
+
+    // Explicit indices address the raw data, a subset maps its rows through its own indices first.
+    const auto& dataset = _datasets[ref.dataset];
+    std::vector<std::uint32_t> indices(rows.begin(), rows.end());
+    if (!dataset->isFull()) {
+        for (auto& index : indices)
+            index = dataset->indices[index];
+    }
+    std::vector<float> values(rows.size());
+    dataset->populateDataForDimensions(values, std::vector<int>{ ref.dimension }, indices);
+    for (size_t i = 0; i < rows.size(); ++i)
+        out[i] = static_cast<double>(values[i]);
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Dataset.h>
+#include <PointData/PointData.h>
+#include <ClusterData/ClusterData.h>
+#include <vector>
+#include "ColumnSource.h"
+#include "ClusterCodes.h"
+
+// Reads single dimensions out of a Points dataset and its same-sized child Points datasets, and label columns out of its cluster children.
+// Only names and cluster labels are gathered up front; dimension values are read when a column is requested.
+class PointsColumnSource : public ColumnSource {
+public:
+    explicit PointsColumnSource(const mv::Dataset<Points>& points);
+
+    int rowCount() const override { return _rows; }
+    int colCount() const override { return static_cast<int>(_columns.size()); }
+
+    QString columnName(int col) const override;
+    bool columnIsNumeric(int col) const override;
+    std::map<QString, QColor> columnLabelColors(int col) const override;
+
+    bool readColumn(int col, std::vector<FastTableData::Value>& out) const override;
+    bool readNumericColumn(int col, NumericBuffer& out) const override;
+    bool readColumnRows(int col, const std::vector<int>& rows, std::vector<FastTableData::Value>& out) const override;
+
+private:
+    struct ColumnRef {
+        QString name;
+        int dataset = -1;   // index into _datasets for dimension columns
+        int dimension = 0;
+        int cluster = -1;   // index into _clusterColumns for label columns
+    };
+
+    void addDataset(const mv::Dataset<Points>& dataset);
+    void addClusterColumn(const mv::Dataset<Clusters>& clusters);
+
+    int _rows = 0;
+    std::vector<mv::Dataset<Points>> _datasets;
+    std::vector<ClusterCodes> _clusterColumns;
+    std::vector<ColumnRef> _columns;
+};
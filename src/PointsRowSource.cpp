@@ -0,0 +1,142 @@
+#include "PointsRowSource.h"
+#include "PointsColumnReader.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+    // Rows read per populateDataForDimensions call while scanning for min/max.
+    constexpr int kScanBlockRows = 65536;
+}
+
+PointsRowSource::PointsRowSource(const mv::Dataset<Points>& points)
+{
+    if (!points.isValid())
+        return;
+
+    _rows = static_cast<int>(points->getNumPoints());
+    addPointGroup(points);
+
+    auto children = points->getChildren();
+    for (const mv::Dataset<Points>& child : children) {
+        if (child->getDataType() == PointType && static_cast<int>(child->getNumPoints()) == _rows && child->getNumDimensions() > 0)
+            addPointGroup(child);
+    }
+    for (const mv::Dataset<Clusters>& child : children) {
+        if (child->getDataType() == ClusterType)
+            addClusterColumn(child);
+    }
+}
+
+void PointsRowSource::addPointGroup(const mv::Dataset<Points>& dataset)
+{
+    PointColumnGroup group;
+    group.dataset = dataset;
+    group.firstColumn = colCount();
+
+    const auto names = dataset->getDimensionNames();
+    const int numDims = static_cast<int>(dataset->getNumDimensions());
+    for (int d = 0; d < numDims; ++d) {
+        group.dimensions.push_back(d);
+        const QString name = d < static_cast<int>(names.size()) ? names[d] : QString();
+        _colNames.push_back(name.isEmpty() ? QString("Dimension %1").arg(group.firstColumn + d + 1) : name);
+        _colIsNumeric.push_back(true);
+        _colMinMax.emplace_back(0.0, 0.0);
+    }
+
+    computeMinMax(group);
+    _pointGroups.push_back(std::move(group));
+}
+
+void PointsRowSource::addClusterColumn(const mv::Dataset<Clusters>& clusters)
+{
+    _clusterColumns.push_back({ colCount(), ClusterCodes::fromClusters(clusters, _rows) });
+    _colNames.push_back(clusters->getGuiName());
+    _colIsNumeric.push_back(false);
+    _colMinMax.emplace_back(0.0, 0.0);
+}
+
+void PointsRowSource::computeMinMax(const PointColumnGroup& group)
+{
+    const int numDims = static_cast<int>(group.dimensions.size());
+    std::vector<double> minVals(numDims, std::numeric_limits<double>::max());
+    std::vector<double> maxVals(numDims, std::numeric_limits<double>::lowest());
+    std::vector<float> block;
+
+    for (int first = 0; first < _rows; first += kScanBlockRows) {
+        const int count = std::min(kScanBlockRows, _rows - first);
+        block.resize(static_cast<size_t>(count) * numDims);
+        group.dataset->populateDataForDimensions(block, group.dimensions, rawRowIndices(group.dataset, first, count));
+        for (int r = 0; r < count; ++r) {
+            for (int d = 0; d < numDims; ++d) {
+                const double value = block[static_cast<size_t>(r) * numDims + d];
+                minVals[d] = std::min(minVals[d], value);
+                maxVals[d] = std::max(maxVals[d], value);
+            }
+        }
+    }
+
+    for (int d = 0; d < numDims; ++d) {
+        if (_rows > 0)
+            _colMinMax[group.firstColumn + d] = { minVals[d], maxVals[d] };
+    }
+}
+
+QString PointsRowSource::columnName(int col) const
+{
+    if (col >= 0 && col < colCount()) return _colNames[col];
+    return {};
+}
+
+bool PointsRowSource::columnIsNumeric(int col) const
+{
+    if (col >= 0 && col < colCount()) return _colIsNumeric[col];
+    return true;
+}
+
+void PointsRowSource::getColumnMinMax(int col, double& minVal, double& maxVal) const
+{
+    if (col >= 0 && col < colCount()) {
+        minVal = _colMinMax[col].first;
+        maxVal = _colMinMax[col].second;
+    } else {
+        minVal = 0.0;
+        maxVal = 0.0;
+    }
+}
+
+std::map<QString, QColor> PointsRowSource::columnLabelColors(int col) const
+{
+    for (const auto& cluster : _clusterColumns) {
+        if (cluster.column == col)
+            return cluster.codes.colors;
+    }
+    return {};
+}
+
+bool PointsRowSource::readRows(int first, int count, std::vector<FastTableData::Value>& out) const
+{
+    if (first < 0 || count < 0 || first + count > _rows)
+        return false;
+
+    const int cols = colCount();
+    out.resize(static_cast<size_t>(count) * cols);
+    if (count == 0)
+        return true;
+
+    std::vector<float> block;
+    for (const auto& group : _pointGroups) {
+        const int numDims = static_cast<int>(group.dimensions.size());
+        block.resize(static_cast<size_t>(count) * numDims);
+        group.dataset->populateDataForDimensions(block, group.dimensions, rawRowIndices(group.dataset, first, count));
+        for (int r = 0; r < count; ++r) {
+            for (int d = 0; d < numDims; ++d)
+                out[static_cast<size_t>(r) * cols + group.firstColumn + d] = static_cast<double>(block[static_cast<size_t>(r) * numDims + d]);
+        }
+    }
+
+    for (const auto& cluster : _clusterColumns) {
+        for (int r = 0; r < count; ++r)
+            out[static_cast<size_t>(r) * cols + cluster.column] = cluster.codes.label(first + r);
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Dataset.h>
+#include <PointData/PointData.h>
+#include <ClusterData/ClusterData.h>
+#include <cstdint>
+#include <vector>
+#include "RowSource.h"
+#include "ClusterCodes.h"
+
+// Pages rows straight out of a Points dataset, its same-sized child Points datasets and its cluster children.
+class PointsRowSource : public RowSource {
+public:
+    explicit PointsRowSource(const mv::Dataset<Points>& points);
+
+    int rowCount() const override { return _rows; }
+    int colCount() const override { return static_cast<int>(_colNames.size()); }
+
+    QString columnName(int col) const override;
+    bool columnIsNumeric(int col) const override;
+    void getColumnMinMax(int col, double& minVal, double& maxVal) const override;
+    std::map<QString, QColor> columnLabelColors(int col) const override;
+
+    bool readRows(int first, int count, std::vector<FastTableData::Value>& out) const override;
+
+private:
+    struct PointColumnGroup {
+        mv::Dataset<Points> dataset;
+        int firstColumn = 0;
+        std::vector<int> dimensions;
+    };
+
+    struct ClusterColumn {
+        int column = 0;
+        ClusterCodes codes;
+    };
+
+    void addPointGroup(const mv::Dataset<Points>& dataset);
+    void addClusterColumn(const mv::Dataset<Clusters>& clusters);
+    void computeMinMax(const PointColumnGroup& group);
+
+    int _rows = 0;
+    std::vector<PointColumnGroup> _pointGroups;
+    std::vector<ClusterColumn> _clusterColumns;
+    std::vector<QString> _colNames;
+    std::vector<bool> _colIsNumeric;
+    std::vector<std::pair<double, double>> _colMinMax;
+};
@@ -0,0 +1,59 @@
+#include "RowPrefetcher.h"
+#include "CachedRowSource.h"
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // How far ahead to warm, in seconds of scrolling at the current speed.
+    constexpr double kLookaheadSeconds = 0.5;
+    // Upper bound on warmed pages, never more than half the cache so on-screen pages survive.
+    constexpr int kMaxPrefetchPages = 8;
+}
+
+RowPrefetcher::RowPrefetcher(QObject* parent)
+    : QObject(parent)
+{
+    _pool.setMaxThreadCount(1);
+    _pool.setThreadPriority(QThread::IdlePriority);
+}
+
+RowPrefetcher::~RowPrefetcher()
+{
+    _pool.clear();
+    _pool.waitForDone();
+}
+
+void RowPrefetcher::setCache(std::shared_ptr<CachedRowSource> cache)
+{
+    _pool.clear();
+    _cache = std::move(cache);
+}
+
+void RowPrefetcher::stop()
+{
+    _pool.clear();
+    _pool.waitForDone();
+    _cache.reset();
+}
+
+void RowPrefetcher::update(int topRow, int visibleRows, double rowsPerSecond)
+{
+    if (!_cache)
+        return;
+
+    const int budgetPages = std::max(1, std::min(kMaxPrefetchPages, _cache->maxPages() / 2));
+    const int budgetRows = budgetPages * _cache->pageRows();
+    const int lookahead = std::clamp(static_cast<int>(std::abs(rowsPerSecond) * kLookaheadSeconds), std::min(visibleRows * 2, budgetRows), budgetRows);
+
+    const int first = rowsPerSecond >= 0.0 ? topRow + visibleRows : std::max(0, topRow - lookahead);
+    const int count = rowsPerSecond >= 0.0 ? lookahead : topRow - first;
+    if (count <= 0 || first >= _cache->rowCount() || _cache->isCached(first, count))
+        return;
+
+    // tryStart drops the request when the worker is busy, stale requests never queue up behind a fast scroll.
+    auto cache = _cache;
+    _pool.tryStart([cache, first, count]() {
+        cache->warm(first, count);
+    });
+}
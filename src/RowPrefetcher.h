@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QObject>
+#include <QThreadPool>
+#include <memory>
+
+class CachedRowSource;
+
+// Warms the row page cache ahead of the scroll direction on an idle-priority worker.
+// At most one warm-up runs at a time and it never reaches further than the prefetch budget.
+class RowPrefetcher : public QObject {
+    Q_OBJECT
+public:
+    explicit RowPrefetcher(QObject* parent = nullptr);
+    ~RowPrefetcher() override;
+
+    void setCache(std::shared_ptr<CachedRowSource> cache);
+    // Drops the cache and waits for a warm-up in flight to finish.
+    void stop();
+
+    // rowsPerSecond is signed: positive when scrolling down.
+    void update(int topRow, int visibleRows, double rowsPerSecond);
+
+private:
+    QThreadPool _pool;
+    std::shared_ptr<CachedRowSource> _cache;
+};
@@ -0,0 +1,62 @@
+#include "RowSelection.h"
+#include <algorithm>
+
+RowSelection::RowSelection(std::vector<std::pair<int, int>> ranges, std::shared_ptr<const FastTableData> table)
+    : _table(std::move(table))
+{
+    // Merge overlapping and adjacent ranges.
+    std::sort(ranges.begin(), ranges.end());
+    for (const auto& range : ranges) {
+        if (range.second < range.first)
+            continue;
+        if (!_ranges.empty() && range.first <= _ranges.back().second + 1)
+            _ranges.back().second = std::max(_ranges.back().second, range.second);
+        else
+            _ranges.push_back(range);
+    }
+
+    _rowsBefore.reserve(_ranges.size());
+    for (const auto& range : _ranges) {
+        _rowsBefore.push_back(_rowCount);
+        _rowCount += range.second - range.first + 1;
+    }
+}
+
+RowSelection RowSelection::fromItemSelection(const QItemSelection& selection, std::shared_ptr<const FastTableData> table)
+{
+    std::vector<std::pair<int, int>> ranges;
+    ranges.reserve(selection.size());
+    for (const QItemSelectionRange& range : selection)
+        ranges.emplace_back(range.top(), range.bottom());
+    return RowSelection(std::move(ranges), std::move(table));
+}
+
+bool RowSelection::contains(int row) const
+{
+    auto it = std::upper_bound(_ranges.begin(), _ranges.end(), row, [](int value, const std::pair<int, int>& range) {
+        return value < range.first;
+    });
+    return it != _ranges.begin() && row <= std::prev(it)->second;
+}
+
+int RowSelection::row(int i) const
+{
+    if (i < 0 || i >= _rowCount)
+        return -1;
+    const auto range = std::upper_bound(_rowsBefore.begin(), _rowsBefore.end(), i) - _rowsBefore.begin() - 1;
+    return _ranges[range].first + (i - _rowsBefore[range]);
+}
+
+int RowSelection::sourceRow(int i) const
+{
+    const int r = row(i);
+    return r >= 0 && _table ? _table->sourceRow(r) : -1;
+}
+
+FastTableData::Value RowSelection::value(int i, int col) const
+{
+    const int r = row(i);
+    if (r < 0 || !_table || r >= _table->rowCount())
+        return {};
+    return _table->get(r, col);
+}
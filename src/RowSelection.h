@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QItemSelection>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "FastTableData.h"
+
+// Selected table rows as merged, ascending row ranges; values are read from a table snapshot only when asked for.
+// Cost is in the number of ranges, so selecting all rows of a huge table is a single range.
+class RowSelection {
+public:
+    RowSelection() = default;
+    RowSelection(std::vector<std::pair<int, int>> ranges, std::shared_ptr<const FastTableData> table);
+
+    static RowSelection fromItemSelection(const QItemSelection& selection, std::shared_ptr<const FastTableData> table);
+
+    // Inclusive [first, last] table rows, ascending and disjoint.
+    const std::vector<std::pair<int, int>>& ranges() const { return _ranges; }
+    int rangeCount() const { return static_cast<int>(_ranges.size()); }
+    int rowCount() const { return _rowCount; }
+    bool isEmpty() const { return _rowCount == 0; }
+    bool contains(int row) const;
+
+    // The i-th selected row, 0 <= i < rowCount().
+    int row(int i) const;
+    int sourceRow(int i) const;
+    // Lazy columns that are not resident read as empty.
+    FastTableData::Value value(int i, int col) const;
+
+    std::shared_ptr<const FastTableData> table() const { return _table; }
+
+private:
+    std::vector<std::pair<int, int>> _ranges;
+    std::vector<int> _rowsBefore; // selected rows before each range
+    int _rowCount = 0;
+    std::shared_ptr<const FastTableData> _table;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QString>
+#include <QColor>
+#include <map>
+#include <vector>
+#include "FastTableData.h"
+
+// Supplies rows on demand to a windowed FastTableData, so only a bounded slice of a large table is materialized.
+class RowSource {
+public:
+    virtual ~RowSource() = default;
+
+    virtual int rowCount() const = 0;
+    virtual int colCount() const = 0;
+
+    virtual QString columnName(int col) const = 0;
+    virtual bool columnIsNumeric(int col) const = 0;
+    virtual void getColumnMinMax(int col, double& minVal, double& maxVal) const = 0;
+
+    // Label -> background color for categorical columns, empty when the column has no color map.
+    virtual std::map<QString, QColor> columnLabelColors(int col) const { return {}; }
+
+    // Reads rows [first, first + count) into out in row-major order (count * colCount() values).
+    virtual bool readRows(int first, int count, std::vector<FastTableData::Value>& out) const = 0;
+};
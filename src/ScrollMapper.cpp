@@ -0,0 +1,67 @@
+#include "ScrollMapper.h"
+#include <algorithm>
+#include <cmath>
+
+void ScrollMapper::setGeometry(qint64 totalRows, int rowHeight, int viewportHeight)
+{
+    _totalRows = std::max<qint64>(totalRows, 0);
+    _rowHeight = std::max(rowHeight, 1);
+    _viewportHeight = std::max(viewportHeight, 0);
+    setTopPixel(_topPixel);
+}
+
+qint64 ScrollMapper::maximumTopPixel() const
+{
+    return std::max<qint64>(0, _totalRows * _rowHeight - _viewportHeight);
+}
+
+void ScrollMapper::setTopPixel(qint64 pixel)
+{
+    _topPixel = std::clamp<qint64>(pixel, 0, maximumTopPixel());
+}
+
+void ScrollMapper::scrollByPixels(qint64 delta)
+{
+    setTopPixel(_topPixel + delta);
+}
+
+qint64 ScrollMapper::topRow() const
+{
+    return _topPixel / _rowHeight;
+}
+
+int ScrollMapper::topRowPixelOffset() const
+{
+    return static_cast<int>(_topPixel % _rowHeight);
+}
+
+double ScrollMapper::pixelsPerStep() const
+{
+    const qint64 maxTop = maximumTopPixel();
+    if (maxTop <= kMaxScrollBarRange)
+        return 1.0;
+    return static_cast<double>(maxTop) / kMaxScrollBarRange;
+}
+
+int ScrollMapper::scrollBarMaximum() const
+{
+    return static_cast<int>(std::min<qint64>(maximumTopPixel(), kMaxScrollBarRange));
+}
+
+int ScrollMapper::scrollBarPageStep() const
+{
+    return std::max(1, static_cast<int>(_viewportHeight / pixelsPerStep()));
+}
+
+int ScrollMapper::scrollBarValue() const
+{
+    return static_cast<int>(std::llround(_topPixel / pixelsPerStep()));
+}
+
+void ScrollMapper::setScrollBarValue(int value)
+{
+    // Only re-anchor when the bar actually moved, so rounding never nudges a pixel-precise position.
+    if (value == scrollBarValue())
+        return;
+    setTopPixel(static_cast<qint64>(std::llround(value * pixelsPerStep())));
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QtGlobal>
+
+// Maps a 64-bit logical pixel position over all source rows onto a bounded int scrollbar range.
+// Relative scrolling (wheel, keys) moves the logical position directly, so it stays pixel precise
+// even when one scrollbar step spans many pixels.
+class ScrollMapper {
+public:
+    static constexpr int kMaxScrollBarRange = 1 << 30;
+
+    void setGeometry(qint64 totalRows, int rowHeight, int viewportHeight);
+
+    qint64 maximumTopPixel() const;
+    qint64 topPixel() const { return _topPixel; }
+    void setTopPixel(qint64 pixel);
+    void scrollByPixels(qint64 delta);
+
+    qint64 topRow() const;
+    int topRowPixelOffset() const;
+
+    int scrollBarMaximum() const;
+    int scrollBarPageStep() const;
+    int scrollBarValue() const;
+    void setScrollBarValue(int value);
+
+private:
+    double pixelsPerStep() const;
+
+    qint64 _totalRows = 0;
+    int _rowHeight = 1;
+    int _viewportHeight = 0;
+    qint64 _topPixel = 0;
+};
@@ -26,9 +26,12 @@ SettingsAction::SettingsAction(TableViewPlugin& TableViewPlugin) :
     setSerializationName("TableViewPlugin:Settings");
     _datasetOptionsHolder.getPointDatasetAction().setSerializationName("LayerSurfer:PointDataset");
     _datasetOptionsHolder.getTableDataVariantAction().setSerializationName("LayerSurfer:TableDataVariant");
+    _datasetOptionsHolder.getTableCacheSizeAction().setSerializationName("TableViewPlugin:TableCacheSize");
     
     _datasetOptionsHolder.getPointDatasetAction().setToolTip("Point Dataset");
     _datasetOptionsHolder.getTableDataVariantAction().setToolTip("Table Data Variant");
+    _datasetOptionsHolder.getTableCacheSizeAction().setToolTip("Memory for keeping built tables of recently shown datasets");
+    _datasetOptionsHolder.getTableCacheSizeAction().setSuffix(" MB");
 
     _datasetOptionsHolder.getPointDatasetAction().setFilterFunction([this](mv::Dataset<DatasetImpl> dataset) -> bool {
         return dataset->getDataType() == PointType;
@@ -38,13 +41,15 @@ SettingsAction::SettingsAction(TableViewPlugin& TableViewPlugin) :
     _datasetOptionsHolder.getTableDataVariantAction().setDefaultWidgetFlags(VariantAction::TextHeuristicRole);
 
     _tableViewAction = new HighPerfTableView();
+    _tableMinimap = new TableMinimap(_tableViewAction);
 }
 
 inline SettingsAction::DatasetOptionsHolder::DatasetOptionsHolder(SettingsAction& settingsAction) :
     HorizontalGroupAction(&settingsAction, "Dataset Options"),
     _settingsOptions(settingsAction),
     _pointDatasetAction(this, "Point dataset"),
-    _tableDataVariant(this, "Table Data Variant")
+    _tableDataVariant(this, "Table Data Variant"),
+    _tableCacheSize(this, "Table cache", 0, 16384, 1024)
 {
     setText("Dataset1 Options");
     setIcon(mv::util::StyledIcon("database"));
@@ -52,6 +57,7 @@ inline SettingsAction::DatasetOptionsHolder::DatasetOptionsHolder(SettingsAction
     setConfigurationFlag(WidgetAction::ConfigurationFlag::Default);
     addAction(&_pointDatasetAction);
     addAction(&_tableDataVariant);
+    addAction(&_tableCacheSize);
 }
 
 void SettingsAction::fromVariantMap(const QVariantMap& variantMap)
@@ -59,6 +65,8 @@ void SettingsAction::fromVariantMap(const QVariantMap& variantMap)
     WidgetAction::fromVariantMap(variantMap);
     _datasetOptionsHolder.getPointDatasetAction().fromParentVariantMap(variantMap);
     _datasetOptionsHolder.getTableDataVariantAction().fromParentVariantMap(variantMap);
+    if (variantMap.contains(_datasetOptionsHolder.getTableCacheSizeAction().getSerializationName()))
+        _datasetOptionsHolder.getTableCacheSizeAction().fromParentVariantMap(variantMap);
 }
 
 QVariantMap SettingsAction::toVariantMap() const
@@ -66,5 +74,6 @@ QVariantMap SettingsAction::toVariantMap() const
     QVariantMap variantMap = WidgetAction::toVariantMap();
     _datasetOptionsHolder.getPointDatasetAction().insertIntoVariantMap(variantMap);
     _datasetOptionsHolder.getTableDataVariantAction().insertIntoVariantMap(variantMap);
+    _datasetOptionsHolder.getTableCacheSizeAction().insertIntoVariantMap(variantMap);
     return variantMap;
 }
\ No newline at end of file
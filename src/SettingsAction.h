@@ -39,6 +39,7 @@
 #include <actions/VerticalToolbarAction.h>
 #include "QStatusBar"
 #include "HighPerfTableView.h"
+#include "TableMinimap.h"
 
 using namespace mv::gui;
 class QMenu;
@@ -63,10 +64,14 @@ public:
         const VariantAction& getTableDataVariantAction() const { return _tableDataVariant; }
         VariantAction& getTableDataVariantAction() { return _tableDataVariant; }
 
+        const IntegralAction& getTableCacheSizeAction() const { return _tableCacheSize; }
+        IntegralAction& getTableCacheSizeAction() { return _tableCacheSize; }
+
     protected:
         SettingsAction& _settingsOptions;
         DatasetPickerAction _pointDatasetAction;
         VariantAction _tableDataVariant;
+        IntegralAction _tableCacheSize;
     };
 
 public:
@@ -79,12 +84,15 @@ public:
     QVariantMap toVariantMap() const override;
 
     HighPerfTableView* getTableViewAction() { return _tableViewAction; }
+    const HighPerfTableView* getTableViewAction() const { return _tableViewAction; }
+    TableMinimap* getTableMinimap() { return _tableMinimap; }
 
 protected:
     TableViewPlugin& _viewerPlugin;
     mv::CoreInterface* _core;
     DatasetOptionsHolder _datasetOptionsHolder;
     HighPerfTableView* _tableViewAction = nullptr;
+    TableMinimap* _tableMinimap = nullptr;
 
     friend class ChannelAction;
 };
\ No newline at end of file
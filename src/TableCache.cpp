@@ -0,0 +1,83 @@
+#include "TableCache.h"
+#include <algorithm>
+
+TableCache::TableCache(qint64 budgetBytes)
+    : _budget(std::max<qint64>(budgetBytes, 0))
+{
+}
+
+void TableCache::setBudget(qint64 budgetBytes)
+{
+    _budget = std::max<qint64>(budgetBytes, 0);
+    evict();
+}
+
+std::shared_ptr<const FastTableData> TableCache::find(const QString& datasetId, quint64 version)
+{
+    auto it = _entries.find(datasetId);
+    if (it == _entries.end() || it->version != version)
+        return nullptr;
+    _lru.splice(_lru.begin(), _lru, it->lru);
+    return it->table;
+}
+
+std::shared_ptr<const FastTableData> TableCache::peek(const QString& datasetId, quint64 version) const
+{
+    auto it = _entries.find(datasetId);
+    if (it == _entries.end() || it->version != version)
+        return nullptr;
+    return it->table;
+}
+
+void TableCache::insert(const QString& datasetId, quint64 version, std::shared_ptr<const FastTableData> table)
+{
+    if (!table || version != this->version(datasetId))
+        return;
+
+    drop(datasetId);
+    const qint64 bytes = table->memoryUsage();
+    if (bytes > _budget)
+        return;
+
+    _lru.push_front(datasetId);
+    _entries.insert(datasetId, Entry{ version, std::move(table), bytes, _lru.begin() });
+    _used += bytes;
+    evict();
+}
+
+void TableCache::invalidate(const QString& datasetId)
+{
+    drop(datasetId);
+    _versions[datasetId] = version(datasetId) + 1;
+}
+
+void TableCache::remove(const QString& datasetId)
+{
+    drop(datasetId);
+    _versions.remove(datasetId);
+}
+
+void TableCache::clear()
+{
+    _lru.clear();
+    _entries.clear();
+    _used = 0;
+}
+
+void TableCache::drop(const QString& datasetId)
+{
+    auto it = _entries.find(datasetId);
+    if (it == _entries.end())
+        return;
+    _used -= it->bytes;
+    _lru.erase(it->lru);
+    _entries.erase(it);
+}
+
+void TableCache::evict()
+{
+    while (_used > _budget && !_lru.empty()) {
+        const QString oldest = _lru.back();
+        drop(oldest);
+    }
+}
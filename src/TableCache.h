@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <list>
+#include <memory>
+#include "FastTableData.h"
+
+// LRU of built tables keyed by dataset id, bounded by an approximate memory budget.
+// Every dataset has a version stamp that invalidate() bumps, so a build started before a change is never stored.
+class TableCache {
+public:
+    explicit TableCache(qint64 budgetBytes = 1024LL * 1024 * 1024);
+
+    void setBudget(qint64 budgetBytes);
+    qint64 budget() const { return _budget; }
+    qint64 usedBytes() const { return _used; }
+
+    quint64 version(const QString& datasetId) const { return _versions.value(datasetId, 0); }
+
+    // Returns the table built for this version of the dataset, or null.
+    std::shared_ptr<const FastTableData> find(const QString& datasetId, quint64 version);
+    // Same as find, without marking the table as used.
+    std::shared_ptr<const FastTableData> peek(const QString& datasetId, quint64 version) const;
+    // Stores a table built for version; ignored when the dataset changed since, or when it alone exceeds the budget.
+    void insert(const QString& datasetId, quint64 version, std::shared_ptr<const FastTableData> table);
+
+    // The dataset's data changed: drops its table and bumps its version.
+    void invalidate(const QString& datasetId);
+    // The dataset is gone: forgets it entirely.
+    void remove(const QString& datasetId);
+    void clear();
+
+private:
+    struct Entry {
+        quint64 version = 0;
+        std::shared_ptr<const FastTableData> table;
+        qint64 bytes = 0;
+        std::list<QString>::iterator lru;
+    };
+
+    void drop(const QString& datasetId);
+    void evict();
+
+    qint64 _budget;
+    qint64 _used = 0;
+    std::list<QString> _lru; // most recently used first
+    QHash<QString, Entry> _entries;
+    QHash<QString, quint64> _versions;
+};
@@ -11,8 +11,9 @@
 #include <QColor>
 #include <cmath>
 #include "CorrelationBarDelegate.h" 
+#include <QtConcurrent>
 
-static QColor getContrastingTextColor(const QColor& bg) {
+QColor getContrastingTextColor(const QColor& bg) {
     double luminance = 0.299 * bg.red() + 0.587 * bg.green() + 0.114 * bg.blue();
     return (luminance > 186) ? QColor(Qt::black) : QColor(Qt::white);
 }
@@ -82,239 +83,158 @@ namespace TableDataUtils {
 
 } // namespace TableDataUtils
 
-FastTableData createTableFromVariantMap(const QVariantMap& map) {
-    std::vector<std::map<QString, QString>> clusterColorMaps;
-    QVariantMap mapCopy = map;
-    int clusterColorMapIdx = 0;
-    while (true) {
-        QString key = QString("__clusterColorMap_%1").arg(clusterColorMapIdx);
-        if (!mapCopy.contains(key))
-            break;
-        QVariant colorMapVar = mapCopy.take(key);
-        QVariantMap colorMapQVar = colorMapVar.toMap();
-        std::map<QString, QString> colorMap;
-        for (auto it = colorMapQVar.begin(); it != colorMapQVar.end(); ++it) {
-            colorMap[it.key()] = it.value().toString();
+namespace {
+    // Rows sampled to decide whether a QVariantList column holds numbers.
+    constexpr int kTypeSampleRows = 1000;
+
+    // One column of a variant-map table, extracted once in its natural type.
+    struct VariantColumn {
+        bool valid = false;
+        bool isNumeric = false;
+        int rows = 0;
+        NumericBuffer numbers;
+        std::vector<FastTableData::Value> labels;
+    };
+
+    bool isNumberType(const QVariant& v) {
+        switch (v.typeId()) {
+            case QMetaType::Double:
+            case QMetaType::Float:
+            case QMetaType::Int:
+            case QMetaType::UInt:
+            case QMetaType::LongLong:
+            case QMetaType::ULongLong:
+            case QMetaType::Short:
+            case QMetaType::UShort:
+                return true;
+            default:
+                return false;
         }
-        clusterColorMaps.push_back(colorMap);
-        ++clusterColorMapIdx;
     }
-    std::map<QString, QString> legacyClusterColorMap;
-    if (mapCopy.contains("__clusterColorMap")) {
-        QVariant colorMapVar = mapCopy.take("__clusterColorMap");
-        QVariantMap colorMapQVar = colorMapVar.toMap();
-        for (auto it = colorMapQVar.begin(); it != colorMapQVar.end(); ++it) {
-            legacyClusterColorMap[it.key()] = it.value().toString();
+
+    bool toNumber(const QVariant& v, double& value) {
+        if (isNumberType(v)) {
+            value = v.toDouble();
+            return true;
         }
+        if (v.typeId() != QMetaType::QString)
+            return false;
+        bool ok = false;
+        value = v.toString().toDouble(&ok);
+        return ok;
     }
 
-    if (mapCopy.isEmpty())
-        return FastTableData();
-
-    QStringList colNames = mapCopy.keys();
-    int cols = colNames.size();
-    int rows = -1;
-    std::vector<QVariantList> columns;
-    columns.reserve(cols);
-
-    for (const QString& col : colNames) {
-        QVariant v = mapCopy.value(col);
-        if (!v.canConvert<QVariantList>())
-            return FastTableData();
-        QVariantList list = v.toList();
-        if (rows == -1)
-            rows = list.size();
-        else if (list.size() != rows)
-            return FastTableData();
-        columns.push_back(list);
+    template <typename T>
+    VariantColumn numericColumn(const QList<T>& list) {
+        VariantColumn column;
+        column.valid = true;
+        column.isNumeric = true;
+        column.rows = static_cast<int>(list.size());
+        column.numbers = std::vector<T>(list.begin(), list.end());
+        return column;
     }
 
-    FastTableData table(rows, cols);
+    // Numbers when the sampled elements are numbers or numeric strings; a later element that is not makes it text.
+    VariantColumn listColumn(const QVariantList& list) {
+        VariantColumn column;
+        column.valid = true;
+        column.rows = static_cast<int>(list.size());
 
-    std::vector<bool> isNumericCol(cols, true);
-    std::vector<double> minVals(cols, std::numeric_limits<double>::max());
-    std::vector<double> maxVals(cols, std::numeric_limits<double>::lowest());
+        const int sampleRows = std::min(column.rows, kTypeSampleRows);
+        double value = 0.0;
+        bool numeric = sampleRows > 0;
+        for (int r = 0; r < sampleRows && numeric; ++r)
+            numeric = toNumber(list[r], value);
 
-    for (int c = 0; c < cols; ++c) {
-        table.setColumnName(c, colNames[c]);
-        for (int r = 0; r < rows; ++r) {
-            const QVariant& v = columns[c][r];
-            FastTableData::Value val;
-            if (v.canConvert<double>()) {
-                val = v.toDouble();
-                double d = v.toDouble();
-                minVals[c] = std::min(minVals[c], d);
-                maxVals[c] = std::max(maxVals[c], d);
-            } else if (v.canConvert<int>()) {
-                val = v.toInt();
-                double d = v.toInt();
-                minVals[c] = std::min(minVals[c], d);
-                maxVals[c] = std::max(maxVals[c], d);
-            } else if (v.canConvert<QString>()) {
-                val = v.toString();
-                isNumericCol[c] = false;
-            } else {
-                val = QString();
-                isNumericCol[c] = false;
+        if (numeric) {
+            std::vector<double> values(column.rows);
+            for (int r = 0; r < column.rows && numeric; ++r)
+                numeric = toNumber(list[r], values[r]);
+            if (numeric) {
+                column.isNumeric = true;
+                column.numbers = std::move(values);
+                return column;
             }
-            table.set(r, c, val);
         }
-        table.setColumnIsNumeric(c, isNumericCol[c]);
-        if (isNumericCol[c])
-            table.setColumnMinMax(c, minVals[c], maxVals[c]);
+
+        column.labels.resize(column.rows);
+        for (int r = 0; r < column.rows; ++r)
+            column.labels[r] = list[r].toString();
+        return column;
     }
 
-    for (int c = 0; c < cols; ++c) {
-        if (isNumericCol[c]) {
-            double minVal = minVals[c], maxVal = maxVals[c];
-            for (int r = 0; r < rows; ++r) {
-                QVariant v = columns[c][r];
-                double d = v.toDouble();
-                QColor bg = getNumericCellColor(d, minVal, maxVal);
-                table.setCellColor(r, c, bg);
-                table.setCellTextColor(r, c, getContrastingTextColor(bg));
-            }
+    // Typed payloads are copied in bulk, anything else goes through QVariantList.
+    VariantColumn extractColumn(const QVariant& v) {
+        const QMetaType type = v.metaType();
+        if (type == QMetaType::fromType<QList<float>>())
+            return numericColumn(v.value<QList<float>>());
+        if (type == QMetaType::fromType<QList<double>>())
+            return numericColumn(v.value<QList<double>>());
+        if (type == QMetaType::fromType<QList<int>>())
+            return numericColumn(v.value<QList<int>>());
+        if (type == QMetaType::fromType<QStringList>()) {
+            const QStringList strings = v.toStringList();
+            VariantColumn column;
+            column.valid = true;
+            column.rows = static_cast<int>(strings.size());
+            column.labels.assign(strings.begin(), strings.end());
+            return column;
         }
+        if (type == QMetaType::fromType<QVariantList>())
+            return listColumn(*static_cast<const QVariantList*>(v.constData()));
+        if (v.canConvert<QVariantList>())
+            return listColumn(v.toList());
+        return {};
     }
 
-    for (int c = 0; c < cols; ++c) {
-        if (!isNumericCol[c]) {
-            const std::map<QString, QString>* colorMapPtr = nullptr;
-            if (c < static_cast<int>(clusterColorMaps.size()))
-                colorMapPtr = &clusterColorMaps[c];
-            else if (!legacyClusterColorMap.empty())
-                colorMapPtr = &legacyClusterColorMap;
-
-            std::map<QString, QColor> labelColorCache;
-            if (colorMapPtr) {
-                for (const auto& pair : *colorMapPtr) {
-                    QColor color(pair.second);
-                    if (color.isValid()) {
-                        labelColorCache[pair.first] = color;
-                    }
-                }
-            }
-            for (int r = 0; r < rows; ++r) {
-                QVariant v = columns[c][r];
-                QString label = v.toString();
-                auto it = labelColorCache.find(label);
-                if (it != labelColorCache.end()) {
-                    table.setCellColor(r, c, it->second);
-                    QColor bgColor = it->second.isValid() ? it->second : QColor();
-                    table.setCellTextColor(r, c, getContrastingTextColor(bgColor));
-                } else {
-                    table.setCellTextColor(r, c, getContrastingTextColor(QColor()));
-                }
-            }
+    std::map<QString, QColor> toLabelColors(const QVariantMap& colorMap) {
+        std::map<QString, QColor> colors;
+        for (auto it = colorMap.begin(); it != colorMap.end(); ++it) {
+            const QColor color(it.value().toString());
+            if (color.isValid())
+                colors[it.key()] = color;
         }
+        return colors;
     }
-
-    return table;
 }
 
-FastTableData createTableFromDatasetData(
-    const std::vector<float>& pointDataset,
-    int numOfRows,
-    std::vector<QString> pointColumnNames,
-    const std::vector<std::vector<QString>>& clusterDataset,
-    const std::vector<QString>& clusterColumnNames,
-    const std::vector<std::map<QString, QString>>& clusterColorMap)
-{
-    if ((pointDataset.empty() || pointColumnNames.size() <= 0) && clusterDataset.empty())
-        return FastTableData();
-    if (numOfRows <= 0)
-        return FastTableData();
+FastTableData createTableFromVariantMap(const QVariantMap& map) {
+    // Cluster color maps are stored next to the columns, one per column index, or one shared legacy map.
+    std::vector<std::map<QString, QColor>> clusterColorMaps;
+    for (int i = 0; map.contains(QString("__clusterColorMap_%1").arg(i)); ++i)
+        clusterColorMaps.push_back(toLabelColors(map.value(QString("__clusterColorMap_%1").arg(i)).toMap()));
+    const std::map<QString, QColor> legacyClusterColorMap = toLabelColors(map.value("__clusterColorMap").toMap());
 
-    int clusterDataColumns = 0;
-    if (!clusterDataset.empty()) {
-        clusterDataColumns = static_cast<int>(clusterDataset[0].size());
+    QStringList colNames;
+    for (auto it = map.keyBegin(); it != map.keyEnd(); ++it) {
+        if (!it->startsWith("__clusterColorMap"))
+            colNames << *it;
     }
-    int totalColumns = (pointColumnNames.size() > 0 ? pointColumnNames.size() : 0) + clusterDataColumns;
-    if (totalColumns == 0)
+    if (colNames.isEmpty())
         return FastTableData();
 
-    FastTableData table(numOfRows, totalColumns);
-
-    if (!pointDataset.empty() && pointColumnNames.size() > 0) {
-        for (int c = 0; c < pointColumnNames.size(); ++c) {
-            if (c < static_cast<int>(pointColumnNames.size()) && !pointColumnNames[c].isEmpty()) {
-                table.setColumnName(c, pointColumnNames[c]);
-            } else {
-                table.setColumnName(c, QString("Dimension %1").arg(c + 1));
-            }
-            table.setColumnIsNumeric(c, true);
-            double minVal = std::numeric_limits<double>::max();
-            double maxVal = std::numeric_limits<double>::lowest();
-            for (int r = 0; r < numOfRows; ++r) {
-                double value = pointDataset[r * pointColumnNames.size() + c];
-                table.set(r, c, value);
-                minVal = std::min(minVal, value);
-                maxVal = std::max(maxVal, value);
-            }
-            table.setColumnMinMax(c, minVal, maxVal);
+    // Columns are extracted in parallel, every payload read once in its own type.
+    QList<VariantColumn> columns = QtConcurrent::blockingMapped<QList<VariantColumn>>(colNames, [&map](const QString& name) {
+        return extractColumn(map.value(name));
+    });
 
-            for (int r = 0; r < numOfRows; ++r) {
-                double value = pointDataset[r * pointColumnNames.size() + c];
-                QColor bg = getNumericCellColor(value, minVal, maxVal);
-                table.setCellColor(r, c, bg);
-                table.setCellTextColor(r, c, getContrastingTextColor(bg));
-            }
-        }
+    const int rows = columns.front().rows;
+    for (const auto& column : columns) {
+        if (!column.valid || column.rows != rows)
+            return FastTableData();
     }
 
-    if (!clusterDataset.empty() && clusterDataset.size() >= static_cast<size_t>(numOfRows)) {
-        for (int c = 0; c < clusterDataColumns; ++c) {
-            int colIdx = (pointColumnNames.size() > 0 ? pointColumnNames.size() : 0) + c;
-            table.setColumnName(colIdx, QString("Cluster %1").arg(c + 1));
-            table.setColumnIsNumeric(colIdx, false);
-            for (int r = 0; r < numOfRows; ++r) {
-                if (static_cast<size_t>(c) < clusterDataset[r].size())
-                    table.set(r, colIdx, clusterDataset[r][c]);
-                else
-                    table.set(r, colIdx, QString());
-            }
-        }
-
-        for (int c = 0; c < clusterDataColumns; ++c) {
-            int colIdx = (pointColumnNames.size() > 0 ? pointColumnNames.size() : 0) + c;
-            const std::map<QString, QString>* colorMapPtr = nullptr;
-            if (c < static_cast<int>(clusterColorMap.size())) {
-                colorMapPtr = &clusterColorMap[c];
-            }
-            std::map<QString, QColor> labelColorCache;
-            if (colorMapPtr) {
-                for (const auto& pair : *colorMapPtr) {
-                    QColor color(pair.second);
-                    if (color.isValid()) {
-                        labelColorCache[pair.first] = color;
-                    }
-                }
-            }
-            for (int r = 0; r < numOfRows; ++r) {
-                if (static_cast<size_t>(c) < clusterDataset[r].size()) {
-                    const QString& clusterLabel = clusterDataset[r][c];
-                    auto it = labelColorCache.find(clusterLabel);
-                    if (it != labelColorCache.end()) {
-                        table.setCellColor(r, colIdx, it->second);
-                        QColor bgColor = it->second.isValid() ? it->second : QColor();
-                        table.setCellTextColor(r, colIdx, getContrastingTextColor(bgColor));
-                    } else {
-                        table.setCellTextColor(r, colIdx, getContrastingTextColor(QColor()));
-                    }
-                }
-            }
+    FastTableData table(rows, 0);
+    for (int c = 0; c < static_cast<int>(columns.size()); ++c) {
+        auto& column = columns[c];
+        if (column.isNumeric) {
+            table.appendNumericColumn(colNames[c], std::move(column.numbers));
+            continue;
         }
+        const auto& labelColors = c < static_cast<int>(clusterColorMaps.size()) ? clusterColorMaps[c] : legacyClusterColorMap;
+        table.appendColumn(colNames[c], std::move(column.labels), false, labelColors);
     }
-
-    for (int c = 0; c < static_cast<int>(clusterColumnNames.size()) && c < clusterDataColumns; ++c) {
-        int colIdx = (pointColumnNames.size() > 0 ? pointColumnNames.size() : 0) + c;
-        table.setColumnName(colIdx, clusterColumnNames[c]);
-    }
-
-    if (table.rowCount() > 0 && table.colCount() > 0)
-        return table;
-
-    return FastTableData();
+    return table;
 }
 
 FastTableData createVariantMapFromDatasetData(
@@ -11,15 +11,6 @@
 
 FastTableData createTableFromVariantMap(const QVariantMap& map);
 
-FastTableData createTableFromDatasetData(
-    const std::vector<float>& pointDataset = std::vector<float>(),
-    int numOfRows = 0,
-    std::vector<QString> pointColumnNames = std::vector<QString>(),
-    const std::vector<std::vector<QString>>& clusterDataset = std::vector<std::vector<QString>>(),
-    const std::vector<QString>& clusterColumnNames = std::vector<QString>(),
-    const std::vector<std::map<QString, QString>>& clusterColorMap = std::vector<std::map<QString, QString>>()
-);
-
 FastTableData createVariantMapFromDatasetData(
     const std::vector<float>& pointDataset,
     int numOfRows,
@@ -30,6 +21,7 @@ FastTableData createVariantMapFromDatasetData(
 );
 
 QColor getNumericCellColor(double value, double minVal, double maxVal);
+QColor getContrastingTextColor(const QColor& bg);
 
 CorrelationBarDelegate::ColorMapType toCorrelationBarColorMapType(HighPerfTableModel::ColorMapType type);
 
@@ -0,0 +1,124 @@
+#include "TableExporter.h"
+#include "TableFile.h"
+#include "TableTextFormat.h"
+#include <QFile>
+#include <QtConcurrent>
+#include <algorithm>
+#include <optional>
+#include <string>
+
+namespace {
+    using TableTextFormat::kChunkRows;
+    using ExportJob = TableTextFormat::Job;
+
+    // Fails on the first chunk whose rows could not be read, so a file is never written with rows missing.
+    bool writeAll(QFile& file, const std::vector<std::optional<std::string>>& buffers)
+    {
+        for (const auto& buffer : buffers) {
+            if (!buffer || file.write(buffer->data(), static_cast<qint64>(buffer->size())) != static_cast<qint64>(buffer->size()))
+                return false;
+        }
+        return true;
+    }
+
+    void exportTable(QPromise<bool>& promise, ExportJob job, QString filePath)
+    {
+        promise.setProgressRange(0, 100);
+        if (TableFile::isTableFile(filePath)) {
+            promise.addResult(TableFile::write(*job.table, job.rows, filePath, [&promise](int percent) {
+                promise.setProgressValue(percent);
+                return !promise.isCanceled();
+            }));
+            return;
+        }
+        const int rowCount = TableTextFormat::rowCount(job);
+
+        QFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            promise.addResult(false);
+            return;
+        }
+
+        std::vector<int> chunks;
+        for (int first = 0; first < rowCount; first += kChunkRows)
+            chunks.push_back(first);
+        const int batchChunks = std::max(2, QThreadPool::globalInstance()->maxThreadCount() * 2);
+        auto formatBatch = [&job, &chunks, batchChunks](int batch) {
+            const auto begin = chunks.begin() + std::min<size_t>(chunks.size(), static_cast<size_t>(batch) * batchChunks);
+            const auto end = chunks.begin() + std::min<size_t>(chunks.size(), static_cast<size_t>(batch + 1) * batchChunks);
+            return QtConcurrent::mapped(std::vector<int>(begin, end), [&job](int first) { return TableTextFormat::formatChunk(job, first); });
+        };
+
+        bool ok = writeAll(file, { TableTextFormat::formatHeader(job) });
+        const int batches = static_cast<int>((chunks.size() + batchChunks - 1) / batchChunks);
+
+        // The next batch is formatted on the pool while this thread writes the current one.
+        QFuture<std::optional<std::string>> formatting = formatBatch(0);
+        for (int batch = 0; batch < batches && ok; ++batch) {
+            formatting.waitForFinished();
+            const QList<std::optional<std::string>> results = formatting.results();
+            if (batch + 1 < batches)
+                formatting = formatBatch(batch + 1);
+
+            if (promise.isCanceled()) {
+                formatting.cancel();
+                formatting.waitForFinished();
+                ok = false;
+                break;
+            }
+            ok = writeAll(file, std::vector<std::optional<std::string>>(results.begin(), results.end()));
+            const qint64 written = std::min<qint64>(static_cast<qint64>(batch + 1) * batchChunks * kChunkRows, rowCount);
+            promise.setProgressValue(rowCount > 0 ? static_cast<int>(100 * written / rowCount) : 100);
+        }
+        formatting.waitForFinished();
+
+        ok = ok && file.flush();
+        file.close();
+        if (!ok)
+            file.remove();
+        promise.addResult(ok);
+    }
+}
+
+TableExporter::TableExporter(QObject* parent)
+    : QObject(parent)
+{
+    connect(&_watcher, &QFutureWatcherBase::progressValueChanged, this, &TableExporter::progressChanged);
+    connect(&_watcher, &QFutureWatcherBase::finished, this, [this]() {
+        const bool canceled = _watcher.isCanceled();
+        const bool success = !canceled && _watcher.resultCount() > 0 && _watcher.result();
+        emit finished(success, canceled, _filePath);
+    });
+}
+
+TableExporter::~TableExporter()
+{
+    cancel();
+    _watcher.waitForFinished();
+}
+
+bool TableExporter::start(std::shared_ptr<const FastTableData> table, const QString& filePath, char delimiter, std::vector<int> rows)
+{
+    if (isBusy() || !table)
+        return false;
+    _filePath = filePath;
+    _watcher.setFuture(QtConcurrent::run(exportTable, ExportJob{ std::move(table), std::move(rows), {}, delimiter }, filePath));
+    return true;
+}
+
+void TableExporter::cancel()
+{
+    if (_watcher.isRunning())
+        _watcher.cancel();
+}
+
+void TableExporter::cancelAndWait()
+{
+    cancel();
+    _watcher.waitForFinished();
+}
+
+bool TableExporter::isBusy() const
+{
+    return _watcher.isRunning();
+}
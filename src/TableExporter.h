@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QString>
+#include <memory>
+#include <vector>
+#include "FastTableData.h"
+
+// Writes a table snapshot as CSV/TSV on worker threads. Row chunks are formatted in parallel straight into
+// UTF-8 buffers while the previous batch is written in order, so memory stays at two batches whatever the table size.
+// A .mvtab path writes the binary columnar table file instead.
+class TableExporter : public QObject {
+    Q_OBJECT
+public:
+    explicit TableExporter(QObject* parent = nullptr);
+    ~TableExporter() override;
+
+    // rows are the table rows to write, in order, empty for all; paged tables always write every source row.
+    bool start(std::shared_ptr<const FastTableData> table, const QString& filePath, char delimiter, std::vector<int> rows = {});
+    void cancel();
+    // Cancels and waits for the export to stop reading the table.
+    void cancelAndWait();
+    bool isBusy() const;
+
+signals:
+    void progressChanged(int percent);
+    // A canceled or failed export removes the partial file.
+    void finished(bool success, bool canceled, const QString& filePath);
+
+private:
+    QFutureWatcher<bool> _watcher;
+    QString _filePath;
+};
@@ -0,0 +1,366 @@
+#include "TableFile.h"
+#include "RowSource.h"
+#include "CachedRowSource.h"
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QStringList>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace TableFile {
+
+namespace {
+    constexpr char kMagic[8] = { 'M', 'V', 'T', 'A', 'B', '\0', '\0', '\0' };
+    constexpr char kTrailerMagic[8] = { 'M', 'V', 'T', 'A', 'B', 'E', 'N', 'D' };
+    constexpr quint32 kVersion = 1;
+    constexpr qint64 kHeaderBytes = 16;
+    constexpr qint64 kTrailerBytes = 16;
+    constexpr qint64 kAlignment = 64;
+    constexpr int kChunkRows = 16384;
+
+    qint64 aligned(qint64 offset)
+    {
+        return (offset + kAlignment - 1) / kAlignment * kAlignment;
+    }
+
+    double toDouble(const FastTableData::Value& value)
+    {
+        if (std::holds_alternative<double>(value)) return std::get<double>(value);
+        if (std::holds_alternative<int>(value)) return static_cast<double>(std::get<int>(value));
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    QString toText(const FastTableData::Value& value)
+    {
+        if (std::holds_alternative<QString>(value)) return std::get<QString>(value);
+        if (std::holds_alternative<int>(value)) return QString::number(std::get<int>(value));
+        return QString::number(std::get<double>(value));
+    }
+
+    // Per column state while writing: the dictionary of a label column and the range of a numeric one.
+    struct ColumnWriter {
+        QHash<QString, quint32> codes;
+        QStringList dictionary;
+        double minVal = std::numeric_limits<double>::max();
+        double maxVal = std::numeric_limits<double>::lowest();
+
+        void measure(double value) {
+            if (std::isnan(value))
+                return;
+            minVal = std::min(minVal, value);
+            maxVal = std::max(maxVal, value);
+        }
+
+        quint32 code(const QString& label) {
+            auto it = codes.find(label);
+            if (it != codes.end())
+                return it.value();
+            const quint32 next = static_cast<quint32>(dictionary.size());
+            codes.insert(label, next);
+            dictionary.append(label);
+            return next;
+        }
+    };
+}
+
+int elementSize(ColumnKind kind)
+{
+    switch (kind) {
+        case ColumnKind::Float32: return 4;
+        case ColumnKind::Float64: return 8;
+        case ColumnKind::Int32: return 4;
+        case ColumnKind::Int16: return 2;
+        case ColumnKind::UInt16: return 2;
+        case ColumnKind::Int8: return 1;
+        case ColumnKind::UInt8: return 1;
+        case ColumnKind::BFloat16: return 2;
+        case ColumnKind::Categorical: return 4;
+    }
+    return 0;
+}
+
+bool isTableFile(const QString& filePath)
+{
+    return QFileInfo(filePath).suffix().compare(QLatin1String(kSuffix), Qt::CaseInsensitive) == 0;
+}
+
+QByteArray encodeFooter(const Footer& footer)
+{
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << footer.rows << footer.primaryKeyColumn << static_cast<quint32>(footer.columns.size());
+    for (const auto& column : footer.columns) {
+        stream << column.name << static_cast<quint8>(column.kind) << column.isNumeric << column.minVal << column.maxVal
+               << column.dataOffset << column.dictionaryOffset << column.dictionaryBytes
+               << static_cast<quint32>(column.labelColors.size());
+        for (const auto& [label, color] : column.labelColors)
+            stream << label << static_cast<quint32>(color.rgba());
+    }
+    return bytes;
+}
+
+bool decodeFooter(const QByteArray& bytes, Footer& footer)
+{
+    QDataStream stream(bytes);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    quint32 cols = 0;
+    stream >> footer.rows >> footer.primaryKeyColumn >> cols;
+    footer.columns.clear();
+    for (quint32 c = 0; c < cols && stream.status() == QDataStream::Ok; ++c) {
+        ColumnEntry column;
+        quint8 kind = 0;
+        quint32 labels = 0;
+        stream >> column.name >> kind >> column.isNumeric >> column.minVal >> column.maxVal
+               >> column.dataOffset >> column.dictionaryOffset >> column.dictionaryBytes >> labels;
+        if (kind > static_cast<quint8>(ColumnKind::Categorical))
+            return false;
+        column.kind = static_cast<ColumnKind>(kind);
+        for (quint32 l = 0; l < labels && stream.status() == QDataStream::Ok; ++l) {
+            QString label;
+            quint32 rgba = 0;
+            stream >> label >> rgba;
+            column.labelColors[label] = QColor::fromRgba(rgba);
+        }
+        footer.columns.push_back(std::move(column));
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+bool readFooter(const uchar* data, qint64 size, Footer& footer)
+{
+    if (!data || size < kHeaderBytes + kTrailerBytes || std::memcmp(data, kMagic, sizeof(kMagic)) != 0)
+        return false;
+    quint32 version = 0;
+    std::memcpy(&version, data + sizeof(kMagic), sizeof(version));
+    if (version != kVersion || std::memcmp(data + size - sizeof(kTrailerMagic), kTrailerMagic, sizeof(kTrailerMagic)) != 0)
+        return false;
+
+    quint64 footerOffset = 0;
+    std::memcpy(&footerOffset, data + size - kTrailerBytes, sizeof(footerOffset));
+    if (footerOffset < static_cast<quint64>(kHeaderBytes) || footerOffset > static_cast<quint64>(size - kTrailerBytes))
+        return false;
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(data + footerOffset), size - kTrailerBytes - footerOffset);
+    if (!decodeFooter(bytes, footer))
+        return false;
+
+    // Every block must lie inside the file.
+    for (const auto& column : footer.columns) {
+        const quint64 blockEnd = column.dataOffset + static_cast<quint64>(footer.rows) * elementSize(column.kind);
+        if (blockEnd > footerOffset || column.dictionaryOffset + column.dictionaryBytes > footerOffset)
+            return false;
+    }
+    return true;
+}
+
+namespace {
+    // Column layout of a table about to be written, and the state gathered while filling its blocks.
+    struct Plan {
+        std::shared_ptr<RowSource> source;
+        int rowCount = 0;
+        int cols = 0;
+        Footer footer;
+        std::vector<const NumericBuffer*> numericColumns;
+        std::vector<ColumnWriter> writers;
+        qint64 blocksEnd = kHeaderBytes;
+    };
+
+    Plan makePlan(const FastTableData& table, const std::vector<int>& rows)
+    {
+        Plan plan;
+        plan.source = table.rowSource();
+        if (const auto cache = table.rowCache())
+            plan.source = cache->underlying();
+        const auto& source = plan.source;
+
+        plan.rowCount = source ? source->rowCount() : !rows.empty() ? static_cast<int>(rows.size()) : table.rowCount();
+        plan.cols = source ? source->colCount() : table.colCount();
+
+        // Column kinds and block offsets; typed columns keep their element type.
+        plan.footer.rows = static_cast<quint32>(plan.rowCount);
+        plan.footer.primaryKeyColumn = source ? -1 : table.primaryKeyColumn();
+        plan.numericColumns.assign(plan.cols, nullptr);
+        plan.writers.resize(plan.cols);
+        qint64 offset = kHeaderBytes;
+        for (int c = 0; c < plan.cols; ++c) {
+            ColumnEntry column;
+            column.name = source ? source->columnName(c) : table.columnName(c);
+            column.isNumeric = source ? source->columnIsNumeric(c) : table.columnIsNumeric(c);
+            const NumericBuffer* numeric = source ? nullptr : table.numericColumn(c);
+            plan.numericColumns[c] = numeric;
+            column.kind = numeric ? static_cast<ColumnKind>(numeric->index())
+                : column.isNumeric ? ColumnKind::Float64 : ColumnKind::Categorical;
+            if (!column.isNumeric)
+                column.labelColors = source ? source->columnLabelColors(c) : table.columnLabelColors(c);
+            offset = aligned(offset);
+            column.dataOffset = static_cast<quint64>(offset);
+            offset += static_cast<qint64>(plan.rowCount) * elementSize(column.kind);
+            plan.footer.columns.push_back(std::move(column));
+        }
+        plan.blocksEnd = offset;
+        return plan;
+    }
+
+    QByteArray header()
+    {
+        QByteArray bytes(kHeaderBytes, '\0');
+        std::memcpy(bytes.data(), kMagic, sizeof(kMagic));
+        std::memcpy(bytes.data() + sizeof(kMagic), &kVersion, sizeof(kVersion));
+        return bytes;
+    }
+
+    // Fills the column blocks at base in row chunks, every column task writing its own block.
+    bool fillBlocks(const FastTableData& table, const std::vector<int>& rows, Plan& plan, uchar* base, const std::function<bool(int)>& progress)
+    {
+        const auto& source = plan.source;
+        const int rowCount = plan.rowCount;
+        const int cols = plan.cols;
+        std::vector<int> columns(cols);
+        std::iota(columns.begin(), columns.end(), 0);
+        std::vector<FastTableData::Value> sourceValues;
+        std::vector<int> chunkRows;
+
+        for (int first = 0; first < rowCount; first += kChunkRows) {
+            const int count = std::min(kChunkRows, rowCount - first);
+            if (source) {
+                if (!source->readRows(first, count, sourceValues))
+                    return false;
+            } else {
+                chunkRows.resize(count);
+                if (rows.empty())
+                    std::iota(chunkRows.begin(), chunkRows.end(), first);
+                else
+                    std::copy_n(rows.begin() + first, count, chunkRows.begin());
+            }
+
+            QtConcurrent::blockingMap(columns, [&](int c) {
+                auto& writer = plan.writers[c];
+                const auto& entry = plan.footer.columns[c];
+                uchar* block = base + entry.dataOffset + static_cast<qint64>(first) * elementSize(entry.kind);
+
+                if (const NumericBuffer* numeric = plan.numericColumns[c]) {
+                    std::visit([&](const auto& values) {
+                        using T = typename std::decay_t<decltype(values)>::value_type;
+                        for (int i = 0; i < count; ++i) {
+                            const T value = values[chunkRows[i]];
+                            std::memcpy(block + static_cast<size_t>(i) * sizeof(T), &value, sizeof(T));
+                            writer.measure(static_cast<double>(NumericKernels::Arithmetic<T>(value)));
+                        }
+                    }, *numeric);
+                    return;
+                }
+
+                std::vector<FastTableData::Value> cells;
+                if (!source)
+                    table.readCells(c, chunkRows, cells);
+                auto cell = [&](int i) -> FastTableData::Value {
+                    if (source)
+                        return sourceValues[static_cast<size_t>(i) * cols + c];
+                    return i < static_cast<int>(cells.size()) ? cells[i] : FastTableData::Value(QString());
+                };
+
+                for (int i = 0; i < count; ++i) {
+                    if (entry.kind == ColumnKind::Categorical) {
+                        const quint32 code = writer.code(toText(cell(i)));
+                        std::memcpy(block + static_cast<size_t>(i) * sizeof(code), &code, sizeof(code));
+                    } else {
+                        const double value = toDouble(cell(i));
+                        std::memcpy(block + static_cast<size_t>(i) * sizeof(value), &value, sizeof(value));
+                        writer.measure(value);
+                    }
+                }
+            });
+
+            if (progress && !progress(static_cast<int>(95LL * (first + count) / rowCount)))
+                return false;
+        }
+        return true;
+    }
+
+    // Everything behind the blocks: the dictionaries, then the footer and the trailer pointing at it.
+    QByteArray tail(Plan& plan)
+    {
+        QByteArray bytes;
+        for (int c = 0; c < plan.cols; ++c) {
+            auto& entry = plan.footer.columns[c];
+            const auto& writer = plan.writers[c];
+            if (entry.kind != ColumnKind::Categorical) {
+                if (writer.minVal <= writer.maxVal) {
+                    entry.minVal = writer.minVal;
+                    entry.maxVal = writer.maxVal;
+                }
+                continue;
+            }
+            QByteArray dictionary;
+            QDataStream stream(&dictionary, QIODevice::WriteOnly);
+            stream.setByteOrder(QDataStream::LittleEndian);
+            stream << writer.dictionary;
+            entry.dictionaryOffset = static_cast<quint64>(plan.blocksEnd + bytes.size());
+            entry.dictionaryBytes = static_cast<quint64>(dictionary.size());
+            bytes.append(dictionary);
+        }
+
+        const quint64 footerOffset = static_cast<quint64>(plan.blocksEnd + bytes.size());
+        bytes.append(encodeFooter(plan.footer));
+        QByteArray trailer(kTrailerBytes, '\0');
+        std::memcpy(trailer.data(), &footerOffset, sizeof(footerOffset));
+        std::memcpy(trailer.data() + sizeof(footerOffset), kTrailerMagic, sizeof(kTrailerMagic));
+        bytes.append(trailer);
+        return bytes;
+    }
+}
+
+bool write(const FastTableData& table, const std::vector<int>& rows, const QString& filePath, const std::function<bool(int)>& progress)
+{
+    Plan plan = makePlan(table, rows);
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate))
+        return false;
+    auto fail = [&file]() {
+        file.close();
+        file.remove();
+        return false;
+    };
+
+    if (file.write(header()) != kHeaderBytes || !file.resize(plan.blocksEnd))
+        return fail();
+
+    // The column blocks are filled through a mapping of the file.
+    if (plan.blocksEnd > kHeaderBytes) {
+        uchar* base = file.map(0, plan.blocksEnd);
+        if (!base)
+            return fail();
+        const bool filled = fillBlocks(table, rows, plan, base, progress);
+        file.unmap(base);
+        if (!filled)
+            return fail();
+    }
+
+    const QByteArray rest = tail(plan);
+    if (!file.seek(plan.blocksEnd) || file.write(rest) != rest.size() || !file.flush())
+        return fail();
+    if (progress)
+        progress(100);
+    file.close();
+    return true;
+}
+
+QByteArray encode(const FastTableData& table, const std::vector<int>& rows)
+{
+    Plan plan = makePlan(table, rows);
+    QByteArray bytes(plan.blocksEnd, '\0');
+    std::memcpy(bytes.data(), header().constData(), kHeaderBytes);
+    if (!fillBlocks(table, rows, plan, reinterpret_cast<uchar*>(bytes.data()), {}))
+        return {};
+    bytes.append(tail(plan));
+    return bytes;
+}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QByteArray>
+#include <QColor>
+#include <QString>
+#include <functional>
+#include <map>
+#include <vector>
+#include "FastTableData.h"
+
+// Binary columnar table file (.mvtab). Layout: a 16-byte header, one fixed-size block per column (native numeric
+// values, or 32-bit dictionary codes for label columns), the string dictionaries, a footer describing every column
+// (name, kind, range, label colors, block offsets) and a trailer pointing at the footer. Blocks are little-endian and
+// 64-byte aligned, so a reader can map the file and only touch the columns it reads.
+namespace TableFile {
+
+inline constexpr char kSuffix[] = "mvtab";
+
+// The numeric kinds follow the alternatives of NumericBuffer.
+enum class ColumnKind : quint8 {
+    Float32, Float64, Int32, Int16, UInt16, Int8, UInt8, BFloat16,
+    Categorical
+};
+
+struct ColumnEntry {
+    QString name;
+    ColumnKind kind = ColumnKind::Float64;
+    bool isNumeric = true;
+    double minVal = 0.0;
+    double maxVal = 0.0;
+    quint64 dataOffset = 0;
+    quint64 dictionaryOffset = 0;
+    quint64 dictionaryBytes = 0;
+    std::map<QString, QColor> labelColors;
+};
+
+struct Footer {
+    quint32 rows = 0;
+    qint32 primaryKeyColumn = -1;
+    std::vector<ColumnEntry> columns;
+};
+
+int elementSize(ColumnKind kind);
+bool isTableFile(const QString& filePath);
+
+QByteArray encodeFooter(const Footer& footer);
+bool decodeFooter(const QByteArray& bytes, Footer& footer);
+// Finds and decodes the footer of a mapped file.
+bool readFooter(const uchar* data, qint64 size, Footer& footer);
+
+// Writes rows (table rows in order, empty for all) of table; paged tables always write every source row.
+// progress gets the percentage done and returns false to cancel, which removes the partial file.
+bool write(const FastTableData& table, const std::vector<int>& rows, const QString& filePath, const std::function<bool(int)>& progress = {});
+// The same layout in memory, e.g. for embedding a table in a project; empty on failure.
+QByteArray encode(const FastTableData& table, const std::vector<int>& rows = {});
+
+}
@@ -0,0 +1,157 @@
+#include "TableFileSource.h"
+#include <QDataStream>
+#include <cstring>
+
+namespace {
+    template <typename T>
+    T load(const uchar* block, qint64 index)
+    {
+        T value;
+        std::memcpy(&value, block + index * static_cast<qint64>(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    NumericBuffer makeBuffer(TableFile::ColumnKind kind)
+    {
+        switch (kind) {
+            case TableFile::ColumnKind::Float32: return std::vector<float>();
+            case TableFile::ColumnKind::Int32: return std::vector<std::int32_t>();
+            case TableFile::ColumnKind::Int16: return std::vector<std::int16_t>();
+            case TableFile::ColumnKind::UInt16: return std::vector<std::uint16_t>();
+            case TableFile::ColumnKind::Int8: return std::vector<std::int8_t>();
+            case TableFile::ColumnKind::UInt8: return std::vector<std::uint8_t>();
+            case TableFile::ColumnKind::BFloat16: return std::vector<BFloat16>();
+            default: return std::vector<double>();
+        }
+    }
+}
+
+TableFileSource::TableFileSource(const QString& filePath)
+    : _file(filePath)
+{
+    if (!_file.open(QIODevice::ReadOnly))
+        return;
+    uchar* data = _file.map(0, _file.size());
+    if (data && !open(data, _file.size()))
+        _file.unmap(data);
+}
+
+TableFileSource::TableFileSource(const QByteArray& bytes)
+    : _bytes(bytes)
+{
+    open(reinterpret_cast<const uchar*>(_bytes.constData()), _bytes.size());
+}
+
+bool TableFileSource::open(const uchar* data, qint64 size)
+{
+    if (!TableFile::readFooter(data, size, _footer)) {
+        _footer = {};
+        return false;
+    }
+
+    // Dictionaries are small next to the code blocks, decode them once.
+    _dictionaries.resize(_footer.columns.size());
+    for (size_t c = 0; c < _footer.columns.size(); ++c) {
+        const auto& column = _footer.columns[c];
+        if (column.kind != TableFile::ColumnKind::Categorical)
+            continue;
+        QDataStream stream(QByteArray::fromRawData(reinterpret_cast<const char*>(data + column.dictionaryOffset), column.dictionaryBytes));
+        stream.setByteOrder(QDataStream::LittleEndian);
+        stream >> _dictionaries[c];
+    }
+    _data = data;
+    return true;
+}
+
+TableFileSource::~TableFileSource()
+{
+    if (_data && _file.isOpen())
+        _file.unmap(const_cast<uchar*>(_data));
+}
+
+QString TableFileSource::columnName(int col) const
+{
+    if (hasColumn(col)) return _footer.columns[col].name;
+    return {};
+}
+
+bool TableFileSource::columnIsNumeric(int col) const
+{
+    if (hasColumn(col)) return _footer.columns[col].isNumeric;
+    return true;
+}
+
+std::map<QString, QColor> TableFileSource::columnLabelColors(int col) const
+{
+    if (hasColumn(col)) return _footer.columns[col].labelColors;
+    return {};
+}
+
+bool TableFileSource::columnRange(int col, double& minVal, double& maxVal) const
+{
+    if (!hasColumn(col) || !_footer.columns[col].isNumeric)
+        return false;
+    minVal = _footer.columns[col].minVal;
+    maxVal = _footer.columns[col].maxVal;
+    return true;
+}
+
+FastTableData::Value TableFileSource::cell(int col, int row) const
+{
+    const uchar* values = block(col);
+    switch (_footer.columns[col].kind) {
+        case TableFile::ColumnKind::Float32: return static_cast<double>(load<float>(values, row));
+        case TableFile::ColumnKind::Float64: return load<double>(values, row);
+        case TableFile::ColumnKind::Int32: return static_cast<int>(load<std::int32_t>(values, row));
+        case TableFile::ColumnKind::Int16: return static_cast<int>(load<std::int16_t>(values, row));
+        case TableFile::ColumnKind::UInt16: return static_cast<int>(load<std::uint16_t>(values, row));
+        case TableFile::ColumnKind::Int8: return static_cast<int>(load<std::int8_t>(values, row));
+        case TableFile::ColumnKind::UInt8: return static_cast<int>(load<std::uint8_t>(values, row));
+        case TableFile::ColumnKind::BFloat16: return static_cast<double>(static_cast<float>(load<BFloat16>(values, row)));
+        case TableFile::ColumnKind::Categorical: {
+            const auto& dictionary = _dictionaries[col];
+            const quint32 code = load<quint32>(values, row);
+            return code < static_cast<quint32>(dictionary.size()) ? dictionary[code] : QString();
+        }
+    }
+    return QString();
+}
+
+bool TableFileSource::readColumn(int col, std::vector<FastTableData::Value>& out) const
+{
+    if (!isValid() || !hasColumn(col))
+        return false;
+    const int rows = rowCount();
+    out.resize(rows);
+    for (int r = 0; r < rows; ++r)
+        out[r] = cell(col, r);
+    return true;
+}
+
+bool TableFileSource::readNumericColumn(int col, NumericBuffer& out) const
+{
+    if (!isValid() || !hasColumn(col) || _footer.columns[col].kind == TableFile::ColumnKind::Categorical)
+        return false;
+
+    // The block holds the values in their native type, one copy brings in the column.
+    out = makeBuffer(_footer.columns[col].kind);
+    std::visit([&](auto& values) {
+        using T = typename std::decay_t<decltype(values)>::value_type;
+        values.resize(rowCount());
+        std::memcpy(values.data(), block(col), values.size() * sizeof(T));
+    }, out);
+    return true;
+}
+
+bool TableFileSource::readColumnRows(int col, const std::vector<int>& rows, std::vector<FastTableData::Value>& out) const
+{
+    if (!isValid() || !hasColumn(col))
+        return false;
+    out.resize(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (rows[i] < 0 || rows[i] >= rowCount())
+            return false;
+        out[i] = cell(col, rows[i]);
+    }
+    return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QFile>
+#include <QStringList>
+#include <vector>
+#include "ColumnSource.h"
+#include "TableFile.h"
+
+// Reads the columns of a .mvtab table file through a read-only mapping of the whole file, or of the same layout in memory.
+// Opening only parses the footer and dictionaries; the pages of a column block are touched when the column is read.
+class TableFileSource : public ColumnSource {
+public:
+    explicit TableFileSource(const QString& filePath);
+    explicit TableFileSource(const QByteArray& bytes);
+    ~TableFileSource() override;
+
+    bool isValid() const { return _data != nullptr; }
+    int primaryKeyColumn() const { return _footer.primaryKeyColumn; }
+
+    int rowCount() const override { return static_cast<int>(_footer.rows); }
+    int colCount() const override { return static_cast<int>(_footer.columns.size()); }
+
+    QString columnName(int col) const override;
+    bool columnIsNumeric(int col) const override;
+    std::map<QString, QColor> columnLabelColors(int col) const override;
+    bool columnRange(int col, double& minVal, double& maxVal) const override;
+
+    bool readColumn(int col, std::vector<FastTableData::Value>& out) const override;
+    bool readNumericColumn(int col, NumericBuffer& out) const override;
+    bool readColumnRows(int col, const std::vector<int>& rows, std::vector<FastTableData::Value>& out) const override;
+
+private:
+    bool hasColumn(int col) const { return col >= 0 && col < colCount(); }
+    const uchar* block(int col) const { return _data + _footer.columns[col].dataOffset; }
+    FastTableData::Value cell(int col, int row) const;
+    bool open(const uchar* data, qint64 size);
+
+    QFile _file;
+    QByteArray _bytes;
+    const uchar* _data = nullptr;
+    TableFile::Footer _footer;
+    std::vector<QStringList> _dictionaries;
+};
@@ -0,0 +1,484 @@
+#include "TableImporter.h"
+#include "FileRowSource.h"
+#include <QByteArray>
+#include <QFile>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace {
+    // Rows parsed for the type inference and the first publish, and the target size of a parallel parse chunk.
+    constexpr int kPreviewRows = 2000;
+    constexpr qint64 kChunkBytes = 8 * 1024 * 1024;
+
+    using Result = TableImporter::Result;
+
+    // Inferred column types, only ever widened: Int32 -> Float64 -> Text.
+    enum class ColumnType { Int32, Float64, Text };
+
+    struct Layout {
+        const char* data = nullptr;
+        qint64 size = 0;
+        char delimiter = ',';
+        std::vector<QString> names;
+        std::vector<ColumnType> types;
+
+        int colCount() const { return static_cast<int>(names.size()); }
+    };
+
+    // Parsed rows of one byte range, numbers as doubles (integers stay exact) and text as QStrings.
+    struct Chunk {
+        int rows = 0;
+        std::vector<std::vector<double>> numbers;
+        std::vector<std::vector<FastTableData::Value>> texts;
+        std::vector<std::pair<double, double>> ranges;
+        std::vector<ColumnType> needed; // widest type the values of each column required
+    };
+
+    bool oddQuotes(const char* begin, const char* end)
+    {
+        return std::count(begin, end, '"') % 2 != 0;
+    }
+
+    // The line break ending the record at begin, skipping the ones inside quoted fields; inQuotes is the quote state
+    // at begin. Escaped quotes come in pairs, so the parity of the quotes before a line break is the state after it.
+    const char* recordEnd(const char* begin, const char* end, bool inQuotes = false)
+    {
+        while (begin < end) {
+            const void* found = std::memchr(begin, '\n', static_cast<size_t>(end - begin));
+            const char* newline = found ? static_cast<const char*>(found) : end;
+            if (oddQuotes(begin, newline))
+                inQuotes = !inQuotes;
+            if (!inQuotes)
+                return newline;
+            begin = newline + 1;
+        }
+        return end;
+    }
+
+    bool isMissing(const char* begin, const char* end)
+    {
+        const size_t length = static_cast<size_t>(end - begin);
+        return length == 0 || (length == 2 && std::memcmp(begin, "NA", 2) == 0);
+    }
+
+    // Parses a whole field as a number; integers that fit 32 bits are reported as such.
+    bool parseNumber(const char* begin, const char* end, double& value, bool& integral)
+    {
+        while (begin < end && *begin == ' ') ++begin;
+        while (end > begin && end[-1] == ' ') --end;
+        if (begin < end && *begin == '+') ++begin;
+        if (begin == end)
+            return false;
+
+        std::int32_t integer = 0;
+        auto [intEnd, intError] = std::from_chars(begin, end, integer);
+        if (intError == std::errc() && intEnd == end) {
+            value = integer;
+            integral = true;
+            return true;
+        }
+        // Floating point from_chars is missing from the libc++ of older Xcode toolchains; the field is not copied here.
+        bool ok = false;
+        value = QByteArray::fromRawData(begin, static_cast<qsizetype>(end - begin)).toDouble(&ok);
+        integral = false;
+        return ok;
+    }
+
+    // Calls field(col, begin, end, quoted) for every field of a line; quoted fields come without their outer quotes.
+    template <typename F>
+    void forEachField(const char* begin, const char* end, char delimiter, F&& field)
+    {
+        int col = 0;
+        const char* pos = begin;
+        while (true) {
+            if (pos < end && *pos == '"') {
+                const char* contentBegin = ++pos;
+                while (pos < end && !(*pos == '"' && (pos + 1 == end || pos[1] != '"')))
+                    pos += (*pos == '"') ? 2 : 1;
+                field(col++, contentBegin, std::min(pos, end), true);
+                pos = std::min(pos + 1, end);
+                const void* next = std::memchr(pos, delimiter, static_cast<size_t>(end - pos));
+                if (!next)
+                    return;
+                pos = static_cast<const char*>(next) + 1;
+                continue;
+            }
+            const void* next = std::memchr(pos, delimiter, static_cast<size_t>(end - pos));
+            const char* fieldEnd = next ? static_cast<const char*>(next) : end;
+            field(col++, pos, fieldEnd, false);
+            if (!next)
+                return;
+            pos = fieldEnd + 1;
+        }
+    }
+
+    QString fieldText(const char* begin, const char* end, bool quoted)
+    {
+        QString text = QString::fromUtf8(begin, static_cast<qsizetype>(end - begin));
+        if (quoted)
+            text.replace(QLatin1String("\"\""), QLatin1String("\""));
+        return text;
+    }
+
+    // Splits [begin, end) into records without their line breaks, skipping empty ones; quoted fields may span lines.
+    template <typename F>
+    void forEachLine(const char* begin, const char* end, F&& line)
+    {
+        while (begin < end) {
+            const char* newline = recordEnd(begin, end);
+            const char* contentEnd = newline;
+            if (contentEnd > begin && contentEnd[-1] == '\r')
+                --contentEnd;
+            if (contentEnd > begin && !line(begin, contentEnd))
+                return;
+            begin = newline + 1;
+        }
+    }
+
+    Chunk parseChunk(const Layout& layout, qint64 first, qint64 last)
+    {
+        const int cols = layout.colCount();
+        Chunk chunk;
+        chunk.numbers.resize(cols);
+        chunk.texts.resize(cols);
+        chunk.ranges.assign(cols, { std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest() });
+        chunk.needed.assign(cols, ColumnType::Int32);
+
+        std::vector<bool> seen(cols);
+        forEachLine(layout.data + first, layout.data + last, [&](const char* begin, const char* end) {
+            std::fill(seen.begin(), seen.end(), false);
+            forEachField(begin, end, layout.delimiter, [&](int col, const char* fieldBegin, const char* fieldEnd, bool quoted) {
+                if (col >= cols)
+                    return;
+                seen[col] = true;
+                if (layout.types[col] == ColumnType::Text) {
+                    chunk.texts[col].push_back(fieldText(fieldBegin, fieldEnd, quoted));
+                    return;
+                }
+
+                double value = std::numeric_limits<double>::quiet_NaN();
+                bool integral = false;
+                if (isMissing(fieldBegin, fieldEnd)) {
+                    chunk.needed[col] = std::max(chunk.needed[col], ColumnType::Float64);
+                } else if (parseNumber(fieldBegin, fieldEnd, value, integral)) {
+                    if (!integral)
+                        chunk.needed[col] = std::max(chunk.needed[col], ColumnType::Float64);
+                    chunk.ranges[col].first = std::min(chunk.ranges[col].first, value);
+                    chunk.ranges[col].second = std::max(chunk.ranges[col].second, value);
+                } else {
+                    chunk.needed[col] = ColumnType::Text;
+                }
+                chunk.numbers[col].push_back(value);
+            });
+
+            // Short lines are padded with missing values.
+            for (int c = 0; c < cols; ++c) {
+                if (seen[c])
+                    continue;
+                if (layout.types[c] == ColumnType::Text) {
+                    chunk.texts[c].push_back(QString());
+                } else {
+                    chunk.numbers[c].push_back(std::numeric_limits<double>::quiet_NaN());
+                    chunk.needed[c] = std::max(chunk.needed[c], ColumnType::Float64);
+                }
+            }
+            ++chunk.rows;
+            return true;
+        });
+        return chunk;
+    }
+
+    // Byte offset just past the first count non-empty lines from first, or the end of the file.
+    qint64 skipLines(const Layout& layout, qint64 first, int count)
+    {
+        const char* end = layout.data + layout.size;
+        const char* pos = end;
+        int lines = 0;
+        forEachLine(layout.data + first, end, [&](const char* begin, const char*) {
+            if (lines++ < count)
+                return true;
+            pos = begin;
+            return false;
+        });
+        return pos - layout.data;
+    }
+
+    // Chunk boundaries over [first, size), each moved to the start of a record. The quotes counted since the previous
+    // boundary tell whether the target offset lies inside a quoted field.
+    std::vector<std::pair<qint64, qint64>> splitChunks(const Layout& layout, qint64 first)
+    {
+        std::vector<std::pair<qint64, qint64>> chunks;
+        while (first < layout.size) {
+            qint64 last = std::min(layout.size, first + kChunkBytes);
+            if (last < layout.size) {
+                const bool inQuotes = oddQuotes(layout.data + first, layout.data + last);
+                last = recordEnd(layout.data + last, layout.data + layout.size, inQuotes) - layout.data + 1;
+            }
+            chunks.emplace_back(first, std::min(last, layout.size));
+            first = last;
+        }
+        return chunks;
+    }
+
+    // Concatenates chunks into a table with the layout types; ranges are set when given.
+    FastTableData buildTable(const Layout& layout, const std::vector<const Chunk*>& chunks,
+        const std::vector<std::pair<double, double>>& ranges = {})
+    {
+        int rows = 0;
+        for (const Chunk* chunk : chunks)
+            rows += chunk->rows;
+
+        const int cols = layout.colCount();
+        std::vector<int> columns(cols);
+        std::iota(columns.begin(), columns.end(), 0);
+        std::vector<std::variant<NumericBuffer, std::vector<FastTableData::Value>>> built(cols);
+
+        // Columns are gathered in parallel and appended in order.
+        QtConcurrent::blockingMap(columns, [&](int c) {
+            if (layout.types[c] == ColumnType::Text) {
+                std::vector<FastTableData::Value> values;
+                values.reserve(rows);
+                for (const Chunk* chunk : chunks)
+                    values.insert(values.end(), chunk->texts[c].begin(), chunk->texts[c].end());
+                built[c] = std::move(values);
+            } else if (layout.types[c] == ColumnType::Int32) {
+                std::vector<std::int32_t> values;
+                values.reserve(rows);
+                for (const Chunk* chunk : chunks) {
+                    for (const double value : chunk->numbers[c])
+                        values.push_back(static_cast<std::int32_t>(value));
+                }
+                built[c] = NumericBuffer(std::move(values));
+            } else {
+                std::vector<double> values;
+                values.reserve(rows);
+                for (const Chunk* chunk : chunks)
+                    values.insert(values.end(), chunk->numbers[c].begin(), chunk->numbers[c].end());
+                built[c] = NumericBuffer(std::move(values));
+            }
+        });
+
+        FastTableData table(rows, 0);
+        for (int c = 0; c < cols; ++c) {
+            if (layout.types[c] == ColumnType::Text) {
+                table.appendColumn(layout.names[c], std::move(std::get<1>(built[c])), false);
+                continue;
+            }
+            table.appendNumericColumn(layout.names[c], std::move(std::get<0>(built[c])));
+            if (c < static_cast<int>(ranges.size()) && ranges[c].first <= ranges[c].second)
+                table.setColumnMinMax(c, ranges[c].first, ranges[c].second);
+        }
+        return table;
+    }
+
+    // Folds the ranges and required types of chunk into the running totals.
+    void accumulate(const Chunk& chunk, std::vector<std::pair<double, double>>& ranges, std::vector<ColumnType>& needed)
+    {
+        for (size_t c = 0; c < ranges.size(); ++c) {
+            ranges[c].first = std::min(ranges[c].first, chunk.ranges[c].first);
+            ranges[c].second = std::max(ranges[c].second, chunk.ranges[c].second);
+            needed[c] = std::max(needed[c], chunk.needed[c]);
+        }
+    }
+
+    void publish(QPromise<Result>& promise, Result::Kind kind, FastTableData&& table)
+    {
+        promise.addResult(Result{ kind, std::make_shared<FastTableData>(std::move(table)) });
+    }
+
+    void importTable(QPromise<Result>& promise, QString filePath, QChar delimiter)
+    {
+        promise.setProgressRange(0, 100);
+
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly) || file.size() == 0)
+            return;
+        const uchar* mapped = file.map(0, file.size());
+        if (!mapped)
+            return;
+
+        Layout layout;
+        layout.data = reinterpret_cast<const char*>(mapped);
+        layout.size = file.size();
+
+        // Header, with the same delimiter guess as the paged file source.
+        const qint64 headerEnd = recordEnd(layout.data, layout.data + layout.size) - layout.data;
+        QByteArray header(layout.data, headerEnd);
+        while (header.endsWith('\r'))
+            header.chop(1);
+        if (header.isEmpty())
+            return;
+        if (!delimiter.isNull())
+            layout.delimiter = delimiter.toLatin1();
+        else if (filePath.endsWith(".tsv", Qt::CaseInsensitive) || filePath.endsWith(".tab", Qt::CaseInsensitive)
+            || (!header.contains(',') && header.contains('\t')))
+            layout.delimiter = '\t';
+        const QStringList names = FileRowSource::splitLine(header, layout.delimiter);
+        for (int c = 0; c < names.size(); ++c)
+            layout.names.push_back(names[c].isEmpty() ? QString("Column %1").arg(c + 1) : names[c]);
+        const int cols = layout.colCount();
+
+        // Infer the types from the first rows: parse them as numbers and keep the widest type each column needed.
+        const qint64 dataBegin = std::min(headerEnd + 1, layout.size);
+        const qint64 previewEnd = skipLines(layout, dataBegin, kPreviewRows);
+        layout.types.assign(cols, ColumnType::Float64);
+        Chunk preview = parseChunk(layout, dataBegin, previewEnd);
+        for (int c = 0; c < cols; ++c) {
+            const bool allMissing = std::all_of(preview.numbers[c].begin(), preview.numbers[c].end(), [](double v) { return std::isnan(v); });
+            const bool integral = preview.needed[c] == ColumnType::Int32;
+            layout.types[c] = preview.needed[c] == ColumnType::Text || allMissing ? ColumnType::Text
+                : integral ? ColumnType::Int32 : ColumnType::Float64;
+        }
+        preview = parseChunk(layout, dataBegin, previewEnd);
+        if (promise.isCanceled())
+            return;
+
+        const auto chunks = splitChunks(layout, previewEnd);
+        if (chunks.empty()) {
+            promise.setProgressValue(100);
+            publish(promise, Result::Kind::Table, buildTable(layout, { &preview }, preview.ranges));
+            return;
+        }
+        publish(promise, Result::Kind::Preview, buildTable(layout, { &preview }, preview.ranges));
+
+        auto ranges = preview.ranges;
+        std::vector<ColumnType> needed = preview.needed;
+        const int batchChunks = std::max(1, QThreadPool::globalInstance()->maxThreadCount());
+        const auto parse = [&layout](const std::pair<qint64, qint64>& range) { return parseChunk(layout, range.first, range.second); };
+        auto fits = [&layout](const std::vector<ColumnType>& required) {
+            for (int c = 0; c < layout.colCount(); ++c) {
+                if (layout.types[c] != ColumnType::Text && required[c] > layout.types[c])
+                    return false;
+            }
+            return true;
+        };
+
+        // Stream the rest in batches of chunks parsed in parallel, while every value fits the inferred types.
+        bool streaming = true;
+        size_t next = 0;
+        while (next < chunks.size() && streaming) {
+            const auto end = chunks.begin() + std::min(chunks.size(), next + batchChunks);
+            const QList<Chunk> batch = QtConcurrent::blockingMapped<QList<Chunk>>(chunks.begin() + next, end, parse);
+            next = end - chunks.begin();
+            if (promise.isCanceled())
+                return;
+
+            std::vector<const Chunk*> parsed;
+            for (const Chunk& chunk : batch) {
+                accumulate(chunk, ranges, needed);
+                parsed.push_back(&chunk);
+            }
+            streaming = fits(needed);
+            if (streaming)
+                publish(promise, Result::Kind::Rows, buildTable(layout, parsed, ranges));
+            promise.setProgressValue(static_cast<int>(95 * chunks[next - 1].second / layout.size));
+        }
+
+        if (streaming) {
+            promise.setProgressValue(100);
+            publish(promise, Result::Kind::Stats, buildTable(layout, { &preview }, ranges));
+            return;
+        }
+
+        // Some value did not fit: widen the types and parse the whole file again, repeating while anything widens.
+        for (bool widened = true; widened;) {
+            for (int c = 0; c < cols; ++c) {
+                if (layout.types[c] != ColumnType::Text)
+                    layout.types[c] = std::max(layout.types[c], needed[c]);
+            }
+            std::vector<std::pair<qint64, qint64>> all = { { dataBegin, previewEnd } };
+            all.insert(all.end(), chunks.begin(), chunks.end());
+            const QList<Chunk> parsed = QtConcurrent::blockingMapped<QList<Chunk>>(all.begin(), all.end(), parse);
+            if (promise.isCanceled())
+                return;
+
+            ranges.assign(cols, { std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest() });
+            needed.assign(cols, ColumnType::Int32);
+            std::vector<const Chunk*> pointers;
+            for (const Chunk& chunk : parsed) {
+                accumulate(chunk, ranges, needed);
+                pointers.push_back(&chunk);
+            }
+            widened = !fits(needed);
+            if (!widened) {
+                promise.setProgressValue(100);
+                publish(promise, Result::Kind::Table, buildTable(layout, pointers, ranges));
+            }
+        }
+    }
+}
+
+TableImporter::TableImporter(QObject* parent)
+    : QObject(parent)
+{
+    connect(&_watcher, &QFutureWatcherBase::resultReadyAt, this, &TableImporter::onResultReady);
+    connect(&_watcher, &QFutureWatcherBase::progressValueChanged, this, &TableImporter::progressChanged);
+    connect(&_watcher, &QFutureWatcherBase::finished, this, [this]() {
+        const bool canceled = _watcher.isCanceled();
+        emit finished(!canceled && _watcher.resultCount() > 0, canceled, _filePath);
+    });
+}
+
+TableImporter::~TableImporter()
+{
+    cancel();
+    _watcher.waitForFinished();
+}
+
+bool TableImporter::start(const QString& filePath, QChar delimiter)
+{
+    if (!QFile::exists(filePath))
+        return false;
+    // A newer import replaces the one in flight, the watcher only reports the newest.
+    cancel();
+    _filePath = filePath;
+    _watcher.setFuture(QtConcurrent::run(importTable, filePath, delimiter));
+    return true;
+}
+
+void TableImporter::cancel()
+{
+    if (_watcher.isRunning())
+        _watcher.cancel();
+}
+
+bool TableImporter::isBusy() const
+{
+    return _watcher.isRunning();
+}
+
+void TableImporter::onResultReady(int index)
+{
+    if (_watcher.isCanceled())
+        return;
+
+    const Result result = _watcher.resultAt(index);
+    if (!result.table)
+        return;
+
+    switch (result.kind) {
+        case Result::Kind::Table:
+            emit tableReady(*result.table);
+            break;
+        case Result::Kind::Preview:
+            emit previewReady(*result.table);
+            break;
+        case Result::Kind::Rows:
+            emit rowsReady(*result.table);
+            break;
+        case Result::Kind::Stats:
+            emit statsReady(*result.table);
+            break;
+    }
+
+    // The future keeps every result until the next import, the receivers already hold their own copy.
+    result.table->clear();
+}
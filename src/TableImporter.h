@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QString>
+#include <memory>
+#include "FastTableData.h"
+
+// Loads a CSV/TSV file into a FastTableData on worker threads. The file is mapped and split on record boundaries (line
+// breaks outside quoted fields) into chunks parsed in parallel; column types are inferred from the first rows, which are
+// published as a preview while the rest streams in as row blocks. A later value that does not fit its inferred type
+// triggers one full rebuild with the widened types instead.
+class TableImporter : public QObject {
+    Q_OBJECT
+public:
+    explicit TableImporter(QObject* parent = nullptr);
+    ~TableImporter() override;
+
+    // delimiter is guessed from the suffix and the header when null.
+    bool start(const QString& filePath, QChar delimiter = QChar());
+    void cancel();
+    bool isBusy() const;
+
+    // One publish step of an import, delivered in order on the GUI thread.
+    struct Result {
+        enum class Kind {
+            Table,      // complete table
+            Preview,    // first rows, with the types inferred from them
+            Rows,       // block to append
+            Stats       // first rows again, carrying the final ranges
+        };
+        Kind kind = Kind::Table;
+        std::shared_ptr<FastTableData> table;
+    };
+
+signals:
+    void progressChanged(int percent);
+    void tableReady(const FastTableData& table);
+    void previewReady(const FastTableData& table);
+    void rowsReady(const FastTableData& block);
+    void statsReady(const FastTableData& firstRows);
+    void finished(bool success, bool canceled, const QString& filePath);
+
+private:
+    void onResultReady(int index);
+
+    QFutureWatcher<Result> _watcher;
+    QString _filePath;
+};
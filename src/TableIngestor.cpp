@@ -0,0 +1,313 @@
+#include "TableIngestor.h"
+#include "PointsRowSource.h"
+#include "PointsColumnSource.h"
+#include "ClusterCodes.h"
+#include "PointsColumnReader.h"
+#include <ClusterData/ClusterData.h>
+#include <QtConcurrent>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <vector>
+
+namespace {
+    // Datasets with more points than this are paged in from the dataset instead of being materialized up front.
+    constexpr int kPagedRowThreshold = 1000000;
+    constexpr int kPagedWindowRows = 20000;
+
+    // Wider than this (in cells) the dimension columns are only read once shown, and at most this many cells stay resident.
+    constexpr qint64 kLazyCellThreshold = 20000000;
+    constexpr qint64 kResidentCellBudget = 20000000;
+
+    // Rows in the first publish of a progressive load, and in each block streamed after it.
+    constexpr int kPreviewRows = 2000;
+    constexpr int kBlockRows = 100000;
+
+    using Result = TableIngestor::Result;
+
+    // Where the columns of the table come from: the dataset, its same-sized child point datasets and its cluster children.
+    struct DatasetLayout {
+        struct PointGroup {
+            mv::Dataset<Points> dataset;
+            std::vector<int> dimensions;
+        };
+
+        int rows = 0;
+        int numDims = 0;
+        std::vector<PointGroup> pointGroups;
+        std::vector<QString> columnNames;
+        std::vector<QString> columnOrigins;
+        std::vector<QString> clusterColumnNames;
+        std::vector<QString> clusterColumnOrigins;
+        std::vector<ClusterCodes> clusterColumns;
+    };
+
+    void addPointGroup(DatasetLayout& layout, const mv::Dataset<Points>& dataset)
+    {
+        DatasetLayout::PointGroup group{ dataset, std::vector<int>(dataset->getNumDimensions()) };
+        std::iota(group.dimensions.begin(), group.dimensions.end(), 0);
+        const auto names = dataset->getDimensionNames();
+        for (int d = 0; d < static_cast<int>(group.dimensions.size()); ++d) {
+            const QString name = d < static_cast<int>(names.size()) ? names[d] : QString();
+            layout.columnNames.push_back(name.isEmpty() ? QString("Dimension %1").arg(layout.numDims + d + 1) : name);
+            layout.columnOrigins.push_back(dataset->getId());
+        }
+        layout.numDims += static_cast<int>(group.dimensions.size());
+        layout.pointGroups.push_back(std::move(group));
+    }
+
+    void addClusterColumn(DatasetLayout& layout, const mv::Dataset<Clusters>& clusters)
+    {
+        layout.clusterColumnNames.push_back(clusters->getGuiName());
+        layout.clusterColumnOrigins.push_back(clusters->getId());
+        layout.clusterColumns.push_back(ClusterCodes::fromClusters(clusters, layout.rows));
+    }
+
+    // Numeric columns for rows [first, first + count), in the element types of their source datasets.
+    std::vector<NumericBuffer> readColumns(const DatasetLayout& layout, int first, int count)
+    {
+        std::vector<NumericBuffer> columns;
+        columns.reserve(layout.numDims);
+        for (const auto& group : layout.pointGroups) {
+            auto groupColumns = readNativeColumns(group.dataset, group.dimensions, first, count);
+            std::move(groupColumns.begin(), groupColumns.end(), std::back_inserter(columns));
+        }
+        return columns;
+    }
+
+    // Builds rows [first, first + count) out of columns, with the final column ranges when given.
+    // Label columns are expanded straight from their cluster codes.
+    FastTableData buildRows(const DatasetLayout& layout, const std::vector<NumericBuffer>& columns, int first, int count,
+        const std::vector<std::pair<double, double>>& columnRanges = {})
+    {
+        FastTableData table(count, 0);
+        for (int c = 0; c < layout.numDims; ++c) {
+            table.appendNumericColumn(layout.columnNames[c], std::visit([first, count](const auto& values) -> NumericBuffer {
+                return std::decay_t<decltype(values)>(values.begin() + first, values.begin() + first + count);
+            }, columns[c]));
+            table.setColumnOrigin(c, layout.columnOrigins[c]);
+            if (c < static_cast<int>(columnRanges.size()))
+                table.setColumnMinMax(c, columnRanges[c].first, columnRanges[c].second);
+        }
+
+        for (size_t c = 0; c < layout.clusterColumns.size(); ++c) {
+            const auto& codes = layout.clusterColumns[c];
+            std::vector<FastTableData::Value> labels(count);
+            for (int r = 0; r < count; ++r)
+                labels[r] = codes.label(first + r);
+            table.appendColumn(layout.clusterColumnNames[c], std::move(labels), false, codes.colors);
+            table.setColumnOrigin(table.colCount() - 1, layout.clusterColumnOrigins[c]);
+        }
+        return table;
+    }
+
+    void publish(QPromise<Result>& promise, Result::Kind kind, FastTableData&& table)
+    {
+        promise.addResult(Result{ kind, std::make_shared<FastTableData>(std::move(table)) });
+    }
+
+    void buildTable(QPromise<Result>& promise, mv::Dataset<Points> points)
+    {
+        promise.setProgressRange(0, 100);
+        const int numOfRows = static_cast<int>(points->getNumPoints());
+
+        if (numOfRows > kPagedRowThreshold) {
+            promise.setProgressValueAndText(0, QObject::tr("Scanning columns"));
+            FastTableData table;
+            table.setRowSource(std::make_shared<PointsRowSource>(points), kPagedWindowRows);
+            promise.setProgressValueAndText(100, QObject::tr("Publishing"));
+            publish(promise, Result::Kind::Table, std::move(table));
+            return;
+        }
+
+        const auto children = points->getChildren();
+        qint64 numericColumns = points->getNumDimensions();
+        for (const mv::Dataset<Points>& child : children) {
+            if (child->getDataType() == PointType && static_cast<int>(child->getNumPoints()) == numOfRows)
+                numericColumns += child->getNumDimensions();
+        }
+
+        if (numericColumns * numOfRows > kLazyCellThreshold) {
+            promise.setProgressValueAndText(0, QObject::tr("Reading clusters"));
+            FastTableData table;
+            table.setColumnSource(std::make_shared<PointsColumnSource>(points), kResidentCellBudget);
+            promise.setProgressValueAndText(100, QObject::tr("Publishing"));
+            publish(promise, Result::Kind::Table, std::move(table));
+            return;
+        }
+
+        // Extract the column layout and the cluster labels.
+        promise.setProgressValueAndText(0, QObject::tr("Reading clusters"));
+        DatasetLayout layout;
+        layout.rows = numOfRows;
+        addPointGroup(layout, points);
+        for (const mv::Dataset<Points>& child : children) {
+            if (child->getDataType() == PointType && static_cast<int>(child->getNumPoints()) == numOfRows && child->getNumDimensions() > 0)
+                addPointGroup(layout, child);
+        }
+        for (const mv::Dataset<Clusters>& child : children) {
+            if (child->getDataType() == ClusterType)
+                addClusterColumn(layout, child);
+            if (promise.isCanceled())
+                return;
+        }
+
+        // Small tables are built in one go.
+        const bool progressive = numOfRows > 2 * kPreviewRows;
+        const int previewRows = progressive ? kPreviewRows : numOfRows;
+
+        // First paint: only the first rows are read, colored against their own ranges.
+        if (progressive) {
+            publish(promise, Result::Kind::Preview, buildRows(layout, readColumns(layout, 0, previewRows), 0, previewRows));
+            if (promise.isCanceled())
+                return;
+        }
+
+        promise.setProgressValueAndText(10, QObject::tr("Reading dimensions"));
+        const auto columns = readColumns(layout, 0, numOfRows);
+        if (promise.isCanceled())
+            return;
+
+        if (!progressive) {
+            promise.setProgressValueAndText(40, QObject::tr("Building columns"));
+            auto table = buildRows(layout, columns, 0, numOfRows);
+            if (promise.isCanceled())
+                return;
+            promise.setProgressValueAndText(100, QObject::tr("Publishing"));
+            publish(promise, Result::Kind::Table, std::move(table));
+            return;
+        }
+
+        // Remaining rows stream in blocks, already colored against the final ranges.
+        std::vector<std::pair<double, double>> ranges;
+        for (const auto& column : columns)
+            ranges.push_back(std::visit([](const auto& values) { return NumericKernels::range(values); }, column));
+        for (int first = previewRows; first < numOfRows; first += kBlockRows) {
+            promise.setProgressValueAndText(30 + static_cast<int>(65LL * first / numOfRows), QObject::tr("Building columns"));
+            const int count = std::min(kBlockRows, numOfRows - first);
+            publish(promise, Result::Kind::Rows, buildRows(layout, columns, first, count, ranges));
+            if (promise.isCanceled())
+                return;
+        }
+
+        // Refine the preview rows and publish the final ranges.
+        promise.setProgressValueAndText(100, QObject::tr("Publishing"));
+        publish(promise, Result::Kind::Stats, buildRows(layout, columns, 0, previewRows, ranges));
+    }
+
+    // Rebuilds only the columns read from the given children of points, all rows at once.
+    void buildColumns(QPromise<Result>& promise, mv::Dataset<Points> points, QStringList datasetIds)
+    {
+        promise.setProgressRange(0, 100);
+        promise.setProgressValueAndText(0, QObject::tr("Reading changed columns"));
+
+        DatasetLayout layout;
+        layout.rows = static_cast<int>(points->getNumPoints());
+        const auto children = points->getChildren();
+        for (const mv::Dataset<Points>& child : children) {
+            if (child->getDataType() == PointType && datasetIds.contains(child->getId())
+                && static_cast<int>(child->getNumPoints()) == layout.rows && child->getNumDimensions() > 0)
+                addPointGroup(layout, child);
+        }
+        for (const mv::Dataset<Clusters>& child : children) {
+            if (child->getDataType() == ClusterType && datasetIds.contains(child->getId()))
+                addClusterColumn(layout, child);
+            if (promise.isCanceled())
+                return;
+        }
+
+        auto table = buildRows(layout, readColumns(layout, 0, layout.rows), 0, layout.rows);
+        if (promise.isCanceled())
+            return;
+        promise.setProgressValueAndText(100, QObject::tr("Publishing"));
+        publish(promise, Result::Kind::Columns, std::move(table));
+    }
+}
+
+TableIngestor::TableIngestor(QObject* parent)
+    : QObject(parent)
+{
+    connect(&_watcher, &QFutureWatcherBase::resultReadyAt, this, &TableIngestor::onResultReady);
+    connect(&_watcher, &QFutureWatcherBase::finished, this, [this]() {
+        emit busyChanged(false);
+    });
+    connect(&_watcher, &QFutureWatcherBase::progressValueChanged, this, [this](int value) {
+        emit progressChanged(value, _watcher.progressText());
+    });
+}
+
+TableIngestor::~TableIngestor()
+{
+    cancel();
+    _watcher.waitForFinished();
+}
+
+void TableIngestor::load(const mv::Dataset<Points>& points)
+{
+    // The stale build stops at its next checkpoint; the watcher only reports the newest one.
+    const bool wasBusy = isBusy();
+    cancel();
+    _watcher.setFuture(QtConcurrent::run(buildTable, points));
+    if (!wasBusy)
+        emit busyChanged(true);
+}
+
+void TableIngestor::loadColumns(const mv::Dataset<Points>& points, const QStringList& datasetIds)
+{
+    const bool wasBusy = isBusy();
+    cancel();
+    _watcher.setFuture(QtConcurrent::run(buildColumns, points, datasetIds));
+    if (!wasBusy)
+        emit busyChanged(true);
+}
+
+void TableIngestor::cancel()
+{
+    if (_watcher.isRunning())
+        _watcher.cancel();
+}
+
+void TableIngestor::cancelAndWait()
+{
+    cancel();
+    _watcher.waitForFinished();
+}
+
+bool TableIngestor::isBusy() const
+{
+    return _watcher.isRunning();
+}
+
+void TableIngestor::onResultReady(int index)
+{
+    if (_watcher.isCanceled())
+        return;
+
+    // Publishing happens here, on the GUI thread, one swap or append per result.
+    const Result result = _watcher.resultAt(index);
+    if (!result.table)
+        return;
+
+    switch (result.kind) {
+        case Result::Kind::Table:
+            emit tableReady(*result.table);
+            break;
+        case Result::Kind::Preview:
+            emit previewReady(*result.table);
+            break;
+        case Result::Kind::Rows:
+            emit rowsReady(*result.table);
+            break;
+        case Result::Kind::Stats:
+            emit statsReady(*result.table);
+            break;
+        case Result::Kind::Columns:
+            emit columnsReady(*result.table);
+            break;
+    }
+
+    // The future keeps every result until the next load, the receivers already hold their own copy.
+    result.table->clear();
+}
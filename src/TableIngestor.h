@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QStringList>
+#include <Dataset.h>
+#include <PointData/PointData.h>
+#include <memory>
+#include "FastTableData.h"
+
+// Builds the table for a points dataset on a worker thread: extract, build columns, stats and colors, publish.
+// Large tables are published progressively: a preview of the first rows, then row blocks, then the final column ranges.
+// The caller keeps showing the current table until the first publish; a newer load cancels the build in flight.
+class TableIngestor : public QObject {
+    Q_OBJECT
+public:
+    explicit TableIngestor(QObject* parent = nullptr);
+    ~TableIngestor() override;
+
+    void load(const mv::Dataset<Points>& points);
+    // Rebuilds only the columns read from the given child datasets of points.
+    void loadColumns(const mv::Dataset<Points>& points, const QStringList& datasetIds);
+    void cancel();
+    // Cancels and blocks until the build stopped reading, before its dataset is removed.
+    void cancelAndWait();
+    bool isBusy() const;
+
+    // One publish step of a build, delivered in order on the GUI thread.
+    struct Result {
+        enum class Kind {
+            Table,      // complete table
+            Preview,    // first rows, colored against their own ranges
+            Rows,       // block to append, colored against the final ranges
+            Stats,      // first rows again, carrying the final ranges
+            Columns     // all rows of the columns of some child datasets, tagged with their origin
+        };
+        Kind kind = Kind::Table;
+        std::shared_ptr<FastTableData> table;
+    };
+
+signals:
+    void progressChanged(int percent, const QString& stage);
+    void busyChanged(bool busy);
+    void tableReady(const FastTableData& table);
+    void previewReady(const FastTableData& table);
+    void rowsReady(const FastTableData& block);
+    void statsReady(const FastTableData& firstRows);
+    void columnsReady(const FastTableData& columns);
+
+private:
+    void onResultReady(int index);
+
+    QFutureWatcher<Result> _watcher;
+};
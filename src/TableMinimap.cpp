@@ -0,0 +1,361 @@
+#include "TableMinimap.h"
+#include "HighPerfTableView.h"
+#include "HighPerfTableModel.h"
+#include "RowSource.h"
+#include "CachedRowSource.h"
+#include "TableDataUtils.h"
+#include <QPainter>
+#include <QMouseEvent>
+#include <QScrollBar>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <optional>
+
+namespace {
+    constexpr int kMinimapWidth = 80;
+    constexpr int kRowChunk = 65536;
+    constexpr int kRebuildDelayMs = 150;
+
+    double toDouble(const FastTableData::Value& v) {
+        if (std::holds_alternative<double>(v)) return std::get<double>(v);
+        if (std::holds_alternative<int>(v)) return static_cast<double>(std::get<int>(v));
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // Column range [first, last) covered by column block bx.
+    std::pair<int, int> blockColumns(int bx, int blockCols, int cols) {
+        return { static_cast<int>(static_cast<qint64>(bx) * cols / blockCols),
+                 static_cast<int>(static_cast<qint64>(bx + 1) * cols / blockCols) };
+    }
+
+    struct BlockAccumulator {
+        std::vector<double> sums;
+        std::vector<int> counts;
+        std::vector<qint64> red, green, blue;
+        std::vector<int> labelCounts;
+    };
+
+    // Rows the minimap spans: the whole source when paged, otherwise the rows of the view.
+    int minimapRowCount(const HighPerfTableModel* model) {
+        return model->isPaged() ? model->sourceRowCount() : model->rowCount();
+    }
+
+    // One linear pass over the table (or its row source when paged), parallel over column blocks.
+    // Under a row filter only the filtered table rows are aggregated, in view order.
+    void aggregateTable(QPromise<TableMinimap::Aggregate>& promise, std::shared_ptr<const FastTableData> table,
+        std::optional<std::vector<int>> tableRows, int blockCols, int blockRows, std::vector<int> blocks, TableMinimap::Aggregate result)
+    {
+        // Bypass the page cache, a full pass would only evict the pages the view is using.
+        auto source = table->rowSource();
+        if (auto cache = table->rowCache())
+            source = cache->underlying();
+        if (source)
+            tableRows.reset();
+        const int rows = source ? source->rowCount() : tableRows ? static_cast<int>(tableRows->size()) : table->rowCount();
+        const int cols = table->colCount();
+        if (rows == 0 || cols == 0 || blockCols == 0 || blockRows == 0) {
+            promise.addResult(TableMinimap::Aggregate{});
+            return;
+        }
+
+        const size_t cells = static_cast<size_t>(blockCols) * blockRows;
+        if (result.blockCols != blockCols || result.blockRows != blockRows) {
+            result.blockCols = blockCols;
+            result.blockRows = blockRows;
+            result.means.assign(cells, std::numeric_limits<float>::quiet_NaN());
+            result.labelColors.assign(cells, 0);
+            result.colormapColumns.assign(blockCols, -1);
+            blocks.clear();
+        }
+        if (blocks.empty()) {
+            blocks.resize(blockCols);
+            std::iota(blocks.begin(), blocks.end(), 0);
+        }
+
+        std::vector<std::pair<double, double>> minMax(cols);
+        std::vector<std::map<QString, QColor>> labelColors(cols);
+        for (int c = 0; c < cols; ++c) {
+            table->getColumnMinMax(c, minMax[c].first, minMax[c].second);
+            if (source && !table->columnIsNumeric(c))
+                labelColors[c] = source->columnLabelColors(c);
+        }
+
+        std::vector<BlockAccumulator> accumulators(blocks.size());
+        for (auto& acc : accumulators) {
+            acc.sums.assign(blockRows, 0.0);
+            acc.counts.assign(blockRows, 0);
+            acc.red.assign(blockRows, 0);
+            acc.green.assign(blockRows, 0);
+            acc.blue.assign(blockRows, 0);
+            acc.labelCounts.assign(blockRows, 0);
+        }
+        std::vector<int> blockSlots(blocks.size());
+        std::iota(blockSlots.begin(), blockSlots.end(), 0);
+
+        promise.setProgressRange(0, rows);
+        std::vector<FastTableData::Value> chunk;
+        for (int first = 0; first < rows; first += kRowChunk) {
+            if (promise.isCanceled())
+                return;
+
+            const int count = std::min(kRowChunk, rows - first);
+            if (source && !source->readRows(first, count, chunk))
+                return;
+
+            QtConcurrent::blockingMap(blockSlots, [&](int slot) {
+                auto& acc = accumulators[slot];
+                const auto [colFirst, colLast] = blockColumns(blocks[slot], blockCols, cols);
+                for (int c = colFirst; c < colLast; ++c) {
+                    const bool numeric = table->columnIsNumeric(c);
+                    const double minVal = minMax[c].first;
+                    const double range = minMax[c].second - minVal;
+                    for (int v = first; v < first + count; ++v) {
+                        const int r = tableRows ? (*tableRows)[v] : v;
+                        if (!source && !table->isRowVisible(r))
+                            continue;
+                        const auto& value = source ? chunk[static_cast<size_t>(v - first) * cols + c] : table->get(r, c);
+                        const int by = static_cast<int>(static_cast<qint64>(v) * blockRows / rows);
+                        if (numeric) {
+                            const double d = toDouble(value);
+                            if (std::isnan(d))
+                                continue;
+                            acc.sums[by] += range > 0.0 ? (d - minVal) / range : 0.5;
+                            acc.counts[by]++;
+                        } else {
+                            QColor color;
+                            if (!source) {
+                                color = table->cellColor(r, c);
+                            } else if (std::holds_alternative<QString>(value)) {
+                                auto it = labelColors[c].find(std::get<QString>(value));
+                                if (it != labelColors[c].end())
+                                    color = it->second;
+                            }
+                            if (!color.isValid())
+                                color = QColor(220, 220, 220);
+                            acc.red[by] += color.red();
+                            acc.green[by] += color.green();
+                            acc.blue[by] += color.blue();
+                            acc.labelCounts[by]++;
+                        }
+                    }
+                }
+            });
+            promise.setProgressValue(first + count);
+        }
+
+        for (size_t slot = 0; slot < blocks.size(); ++slot) {
+            const int bx = blocks[slot];
+            const auto& acc = accumulators[slot];
+            const auto [colFirst, colLast] = blockColumns(bx, blockCols, cols);
+            result.colormapColumns[bx] = -1;
+            for (int c = colFirst; c < colLast; ++c) {
+                if (table->columnIsNumeric(c)) {
+                    result.colormapColumns[bx] = c;
+                    break;
+                }
+            }
+            for (int by = 0; by < blockRows; ++by) {
+                const size_t cell = static_cast<size_t>(by) * blockCols + bx;
+                result.means[cell] = acc.counts[by] > 0
+                    ? static_cast<float>(acc.sums[by] / acc.counts[by])
+                    : std::numeric_limits<float>::quiet_NaN();
+                const int n = acc.labelCounts[by];
+                result.labelColors[cell] = n > 0 ? qRgb(acc.red[by] / n, acc.green[by] / n, acc.blue[by] / n) : 0;
+            }
+        }
+        promise.addResult(std::move(result));
+    }
+}
+
+TableMinimap::TableMinimap(HighPerfTableView* view, QWidget* parent)
+    : QWidget(parent)
+    , _view(view)
+{
+    setFixedWidth(kMinimapWidth);
+    setCursor(Qt::PointingHandCursor);
+    setToolTip(tr("Table overview, click to jump"));
+
+    _rebuildTimer.setSingleShot(true);
+    connect(&_rebuildTimer, &QTimer::timeout, this, &TableMinimap::startRebuild);
+    connect(&_watcher, &QFutureWatcher<Aggregate>::finished, this, &TableMinimap::onRebuildFinished);
+
+    auto* model = _view->model();
+    connect(model, &QAbstractItemModel::modelReset, this, [this]() { scheduleRebuild(); });
+    connect(model, &QAbstractItemModel::layoutChanged, this, [this]() { scheduleRebuild(); });
+    connect(model, &QAbstractItemModel::columnsInserted, this, [this]() { scheduleRebuild(); });
+    connect(model, &QAbstractItemModel::columnsRemoved, this, [this]() { scheduleRebuild(); });
+    // Row paging only moves the resident window, the minimap already covers the whole source.
+    connect(model, &QAbstractItemModel::rowsInserted, this, [this, model]() { if (!model->isPaged()) scheduleRebuild(); });
+    connect(model, &QAbstractItemModel::rowsRemoved, this, [this, model]() { if (!model->isPaged()) scheduleRebuild(); });
+    connect(model, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex& topLeft, const QModelIndex& bottomRight, const QList<int>& roles) {
+        if (roles.size() == 1 && roles.first() == Qt::BackgroundRole)
+            composeImage();
+        else
+            scheduleRebuild(topLeft.column(), bottomRight.column());
+    });
+
+    connect(_view->verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() { update(); });
+    connect(_view->horizontalScrollBar(), &QScrollBar::valueChanged, this, [this]() { update(); });
+}
+
+TableMinimap::~TableMinimap()
+{
+    _watcher.cancel();
+    _watcher.waitForFinished();
+}
+
+void TableMinimap::cancelAndWait()
+{
+    _watcher.cancel();
+    _watcher.waitForFinished();
+}
+
+QSize TableMinimap::sizeHint() const
+{
+    return QSize(kMinimapWidth, 200);
+}
+
+void TableMinimap::scheduleRebuild(int firstColumn, int lastColumn)
+{
+    if (lastColumn < 0) {
+        // Full rebuild, forget any partial range.
+        _dirtyFirstColumn = 0;
+        _dirtyLastColumn = std::numeric_limits<int>::max();
+    } else if (_dirtyFirstColumn < 0) {
+        _dirtyFirstColumn = firstColumn;
+        _dirtyLastColumn = lastColumn;
+    } else {
+        _dirtyFirstColumn = std::min(_dirtyFirstColumn, firstColumn);
+        _dirtyLastColumn = std::max(_dirtyLastColumn, lastColumn);
+    }
+    _rebuildTimer.start(kRebuildDelayMs);
+}
+
+void TableMinimap::startRebuild()
+{
+    if (_watcher.isRunning()) {
+        // Let the stale pass stop, the finished handler restarts with the accumulated range.
+        _watcher.cancel();
+        return;
+    }
+    if (_dirtyFirstColumn < 0)
+        return;
+
+    auto* model = _view->model();
+    auto table = model->snapshot();
+    auto tableRows = model->filteredTableRows();
+    const int rows = minimapRowCount(model);
+    const int cols = table->colCount();
+    const int blockCols = std::min(cols, std::max(1, width()));
+    const int blockRows = std::min(rows, std::max(1, height()));
+
+    std::vector<int> blocks;
+    const bool partial = _dirtyLastColumn != std::numeric_limits<int>::max()
+        && _aggregate.blockCols == blockCols && _aggregate.blockRows == blockRows && cols > 0;
+    if (partial) {
+        const int lastCol = std::min(_dirtyLastColumn, cols - 1);
+        for (int bx = 0; bx < blockCols; ++bx) {
+            const auto [colFirst, colLast] = blockColumns(bx, blockCols, cols);
+            if (colLast > _dirtyFirstColumn && colFirst <= lastCol)
+                blocks.push_back(bx);
+        }
+    }
+    _dirtyFirstColumn = -1;
+    _dirtyLastColumn = -1;
+
+    _watcher.setFuture(QtConcurrent::run(aggregateTable, table, std::move(tableRows), blockCols, blockRows, blocks, partial ? _aggregate : Aggregate{}));
+}
+
+void TableMinimap::onRebuildFinished()
+{
+    const auto future = _watcher.future();
+    if (!future.isCanceled() && future.resultCount() > 0) {
+        _aggregate = future.result();
+        composeImage();
+    }
+    if (_dirtyFirstColumn >= 0)
+        startRebuild();
+}
+
+void TableMinimap::composeImage()
+{
+    if (_aggregate.blockCols == 0 || _aggregate.blockRows == 0) {
+        _image = QImage();
+        update();
+        return;
+    }
+
+    auto* model = _view->model();
+    _image = QImage(_aggregate.blockCols, _aggregate.blockRows, QImage::Format_RGB32);
+    _image.fill(palette().color(QPalette::Base));
+    for (int by = 0; by < _aggregate.blockRows; ++by) {
+        auto* line = reinterpret_cast<QRgb*>(_image.scanLine(by));
+        for (int bx = 0; bx < _aggregate.blockCols; ++bx) {
+            const size_t cell = static_cast<size_t>(by) * _aggregate.blockCols + bx;
+            const float mean = _aggregate.means[cell];
+            const int colormapColumn = _aggregate.colormapColumns[bx];
+            if (!std::isnan(mean) && colormapColumn >= 0)
+                line[bx] = TableDataUtils::colormapColor(mean, model->columnColorMap(colormapColumn)).rgb();
+            else if (_aggregate.labelColors[cell] != 0)
+                line[bx] = _aggregate.labelColors[cell];
+        }
+    }
+    update();
+}
+
+void TableMinimap::paintEvent(QPaintEvent*)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().color(QPalette::Base));
+    if (_image.isNull())
+        return;
+
+    painter.drawImage(rect(), _image);
+
+    // Outline the part of the table currently shown in the view.
+    const int rows = minimapRowCount(_view->model());
+    const int cols = _view->model()->columnCount();
+    if (rows <= 0 || cols <= 0)
+        return;
+    const auto [firstRow, lastRow] = _view->visibleSourceRows();
+    const auto [firstCol, lastCol] = _view->visibleColumns();
+    const QRect visible(
+        QPoint(static_cast<int>(static_cast<qint64>(firstCol) * width() / cols), static_cast<int>(static_cast<qint64>(firstRow) * height() / rows)),
+        QPoint(static_cast<int>(static_cast<qint64>(lastCol + 1) * width() / cols) - 1, static_cast<int>(static_cast<qint64>(lastRow + 1) * height() / rows)));
+    painter.setPen(QPen(palette().color(QPalette::Highlight), 2));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(visible.adjusted(1, 1, -1, -1));
+}
+
+void TableMinimap::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    scheduleRebuild();
+}
+
+void TableMinimap::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() == Qt::LeftButton)
+        jumpTo(event->position().toPoint());
+}
+
+void TableMinimap::mouseMoveEvent(QMouseEvent* event)
+{
+    if (event->buttons() & Qt::LeftButton)
+        jumpTo(event->position().toPoint());
+}
+
+void TableMinimap::jumpTo(const QPoint& pos)
+{
+    const int rows = minimapRowCount(_view->model());
+    const int cols = _view->model()->columnCount();
+    if (rows <= 0 || cols <= 0 || height() <= 0 || width() <= 0)
+        return;
+
+    const int row = std::clamp(static_cast<int>(static_cast<qint64>(pos.y()) * rows / height()), 0, rows - 1);
+    const int col = std::clamp(static_cast<int>(static_cast<qint64>(pos.x()) * cols / width()), 0, cols - 1);
+    _view->scrollToSourcePosition(row, col);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QWidget>
+#include <QImage>
+#include <QTimer>
+#include <QFutureWatcher>
+#include <QRgb>
+#include <memory>
+#include <vector>
+#include "FastTableData.h"
+
+class HighPerfTableView;
+
+// Whole-table heatmap next to HighPerfTableView: one pixel per aggregated block of rows and columns.
+// Aggregation runs on a worker thread over a model snapshot; clicking jumps the view to that block.
+class TableMinimap : public QWidget {
+    Q_OBJECT
+public:
+    explicit TableMinimap(HighPerfTableView* view, QWidget* parent = nullptr);
+    ~TableMinimap() override;
+
+    QSize sizeHint() const override;
+
+    // Stops an aggregation in flight and waits for it, the next rebuild follows the model as usual.
+    void cancelAndWait();
+
+    // Per-block aggregate, blockCols x blockRows, stored row-major.
+    struct Aggregate {
+        int blockCols = 0;
+        int blockRows = 0;
+        std::vector<float> means;          // normalized mean of the numeric cells in the block, NaN if none
+        std::vector<QRgb> labelColors;     // averaged label color for blocks without numeric cells
+        std::vector<int> colormapColumns;  // first numeric column of each column block, -1 if none
+    };
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+
+private:
+    void scheduleRebuild(int firstColumn = 0, int lastColumn = -1);
+    void startRebuild();
+    void onRebuildFinished();
+    void composeImage();
+    void jumpTo(const QPoint& pos);
+
+    HighPerfTableView* _view;
+    QTimer _rebuildTimer;
+    QFutureWatcher<Aggregate> _watcher;
+    Aggregate _aggregate;
+    QImage _image;
+    int _dirtyFirstColumn = -1;
+    int _dirtyLastColumn = -1;
+};
@@ -0,0 +1,128 @@
+#include "TableState.h"
+#include "HighPerfTableView.h"
+#include "TableFile.h"
+#include "TableFileSource.h"
+#include <QDataStream>
+#include <QHeaderView>
+#include <QIODevice>
+
+namespace TableState {
+
+namespace {
+    constexpr quint32 kMagic = 0x4d565453; // "MVTS"
+    constexpr quint8 kVersion = 1;
+
+    // Larger tables are the lazily read ones, rebuilding them from the dataset beats storing a copy.
+    constexpr qint64 kMaxStoredCells = 20000000;
+}
+
+QByteArray save(const HighPerfTableView& view, const QString& datasetId, bool withContent)
+{
+    const HighPerfTableModel* model = view.model();
+    const auto table = model->snapshot();
+    const int cols = model->columnCount();
+
+    QByteArray blob;
+    QDataStream stream(&blob, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << kMagic << kVersion << datasetId;
+
+    const QHeaderView* header = view.horizontalHeader();
+    const bool sorted = view.isSortingEnabled() && header->isSortIndicatorShown() && header->sortIndicatorSection() < cols;
+    stream << static_cast<qint32>(sorted ? header->sortIndicatorSection() : -1) << static_cast<quint8>(header->sortIndicatorOrder())
+           << view.showBars() << view.showOnlySelectedRows();
+
+    stream << static_cast<quint32>(cols);
+    for (int c = 0; c < cols; ++c)
+        stream << static_cast<qint32>(view.columnWidth(c));
+    for (int c = 0; c < cols; ++c)
+        stream << static_cast<quint8>(model->columnColorMap(c));
+
+    // Content is written in source row order, so restoring needs no row mapping.
+    QByteArray content;
+    if (withContent && !table->hasRowSource() && table->colCount() > 0 && static_cast<qint64>(table->rowCount()) * table->colCount() <= kMaxStoredCells) {
+        std::vector<int> rows(table->rowCount());
+        for (int r = 0; r < table->rowCount(); ++r)
+            rows[table->sourceRow(r)] = r;
+        content = TableFile::encode(*table, rows);
+    }
+    stream << content;
+    return blob;
+}
+
+bool restore(const QByteArray& blob, Saved& saved)
+{
+    if (blob.isEmpty())
+        return false;
+
+    QDataStream stream(blob);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    quint32 magic = 0;
+    quint8 version = 0;
+    stream >> magic >> version;
+    if (magic != kMagic || version != kVersion)
+        return false;
+
+    qint32 sortColumn = -1;
+    quint8 sortOrder = 0;
+    quint32 cols = 0;
+    stream >> saved.datasetId >> sortColumn >> sortOrder >> saved.view.showBars >> saved.view.showOnlySelectedRows >> cols;
+    saved.view.sortColumn = sortColumn;
+    saved.view.sortOrder = sortOrder ? Qt::DescendingOrder : Qt::AscendingOrder;
+
+    saved.view.columnWidths.clear();
+    saved.view.colorMaps.clear();
+    for (quint32 c = 0; c < cols && stream.status() == QDataStream::Ok; ++c) {
+        qint32 width = 0;
+        stream >> width;
+        saved.view.columnWidths.push_back(width);
+    }
+    for (quint32 c = 0; c < cols && stream.status() == QDataStream::Ok; ++c) {
+        quint8 colorMap = 0;
+        stream >> colorMap;
+        saved.view.colorMaps[static_cast<int>(c)] = static_cast<HighPerfTableModel::ColorMapType>(colorMap);
+    }
+
+    QByteArray content;
+    stream >> content;
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    // Columns stay in the blob until shown; their ranges come from the footer.
+    saved.table.reset();
+    if (!content.isEmpty()) {
+        auto source = std::make_shared<TableFileSource>(content);
+        if (source->isValid()) {
+            auto table = std::make_shared<FastTableData>();
+            table->setColumnSource(source);
+            table->setPrimaryKeyColumn(source->primaryKeyColumn());
+            saved.table = std::move(table);
+        }
+    }
+    return true;
+}
+
+void apply(HighPerfTableView& view, const ViewState& state)
+{
+    HighPerfTableModel* model = view.model();
+    const int cols = model->columnCount();
+
+    view.setShowBars(state.showBars);
+    for (const auto& [col, colorMap] : state.colorMaps) {
+        if (col < cols && model->isNumericalColumn(col))
+            model->setColumnColorMap(col, colorMap);
+    }
+    if (static_cast<int>(state.columnWidths.size()) == cols) {
+        for (int c = 0; c < cols; ++c) {
+            if (state.columnWidths[c] > 0)
+                view.setColumnWidth(c, state.columnWidths[c]);
+        }
+    }
+    if (state.sortColumn >= 0 && state.sortColumn < cols && view.isSortingEnabled())
+        view.sortByColumn(state.sortColumn, state.sortOrder);
+    view.setShowOnlySelectedRows(state.showOnlySelectedRows);
+}
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <map>
+#include <memory>
+#include <vector>
+#include "FastTableData.h"
+#include "HighPerfTableModel.h"
+
+class HighPerfTableView;
+
+// The state of a HighPerfTableView as one compact blob for the project file: sort order, row filter, column widths,
+// colormaps and, for fully built tables, the content in the binary table file layout with its column ranges.
+namespace TableState {
+
+struct ViewState {
+    int sortColumn = -1;
+    Qt::SortOrder sortOrder = Qt::AscendingOrder;
+    bool showBars = true;
+    bool showOnlySelectedRows = false;
+    std::vector<int> columnWidths;
+    std::map<int, HighPerfTableModel::ColorMapType> colorMaps;
+};
+
+struct Saved {
+    QString datasetId;
+    ViewState view;
+    // Rows in source order, read lazily from the blob; null when the content was not stored.
+    std::shared_ptr<const FastTableData> table;
+};
+
+// Content is only stored with withContent, for the completed build of the dataset; paged and very large tables are
+// rebuilt from their dataset as well, only their view state is stored.
+QByteArray save(const HighPerfTableView& view, const QString& datasetId, bool withContent);
+bool restore(const QByteArray& blob, Saved& saved);
+
+// Applies state to the table shown in view; the sort is only redone when one was stored.
+void apply(HighPerfTableView& view, const ViewState& state);
+
+}
@@ -0,0 +1,176 @@
+#include "TableTextFormat.h"
+#include "RowSource.h"
+#include "CachedRowSource.h"
+#include <algorithm>
+#include <charconv>
+#include <numeric>
+#include <type_traits>
+
+namespace TableTextFormat {
+
+namespace {
+    // Paged tables are read past their page cache, so formatting does not evict the pages on screen.
+    std::shared_ptr<RowSource> textSource(const FastTableData& table)
+    {
+        if (const auto cache = table.rowCache())
+            return cache->underlying();
+        return table.rowSource();
+    }
+
+    std::vector<int> jobColumns(const Job& job, int colCount)
+    {
+        if (!job.columns.empty())
+            return job.columns;
+        std::vector<int> columns(colCount);
+        std::iota(columns.begin(), columns.end(), 0);
+        return columns;
+    }
+
+    template <typename T>
+    void appendNumber(std::string& out, T value)
+    {
+        char buffer[64];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+
+    void appendDouble(std::string& out, double value)
+    {
+        // Most values were floats before they were widened; those get the shortest float text, which reads back exactly.
+        const float narrowed = static_cast<float>(value);
+        if (static_cast<double>(narrowed) == value)
+            appendNumber(out, narrowed);
+        else
+            appendNumber(out, value);
+    }
+
+    void appendText(std::string& out, const QString& text, char delimiter)
+    {
+        const QByteArray utf8 = text.toUtf8();
+        const bool quote = utf8.contains(delimiter) || utf8.contains('"') || utf8.contains('\n') || utf8.contains('\r');
+        if (!quote) {
+            out.append(utf8.constData(), utf8.size());
+            return;
+        }
+        out.push_back('"');
+        for (const char c : utf8) {
+            if (c == '"')
+                out.push_back('"');
+            out.push_back(c);
+        }
+        out.push_back('"');
+    }
+
+    void appendValue(std::string& out, const FastTableData::Value& value, char delimiter)
+    {
+        if (std::holds_alternative<double>(value))
+            appendDouble(out, std::get<double>(value));
+        else if (std::holds_alternative<int>(value))
+            appendNumber(out, std::get<int>(value));
+        else
+            appendText(out, std::get<QString>(value), delimiter);
+    }
+
+    // Reads the given source rows, one readRows per run of consecutive rows.
+    bool readSourceRows(const RowSource& source, const std::vector<int>& rows, std::vector<FastTableData::Value>& out)
+    {
+        const size_t cols = static_cast<size_t>(source.colCount());
+        out.resize(rows.size() * cols);
+        std::vector<FastTableData::Value> run;
+        for (size_t i = 0; i < rows.size();) {
+            size_t end = i + 1;
+            while (end < rows.size() && rows[end] == rows[end - 1] + 1)
+                ++end;
+            if (!source.readRows(rows[i], static_cast<int>(end - i), run))
+                return false;
+            std::move(run.begin(), run.end(), out.begin() + i * cols);
+            i = end;
+        }
+        return true;
+    }
+}
+
+int rowCount(const Job& job)
+{
+    if (!job.rows.empty())
+        return static_cast<int>(job.rows.size());
+    return job.table->rowSource() ? job.table->sourceRowCount() : job.table->rowCount();
+}
+
+std::string formatHeader(const Job& job)
+{
+    std::string out;
+    const auto& table = *job.table;
+    const auto source = textSource(table);
+    const auto columns = jobColumns(job, source ? source->colCount() : table.colCount());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (i > 0)
+            out.push_back(job.delimiter);
+        appendText(out, source ? source->columnName(columns[i]) : table.columnName(columns[i]), job.delimiter);
+    }
+    out.push_back('\n');
+    return out;
+}
+
+std::optional<std::string> formatChunk(const Job& job, int first)
+{
+    std::string out;
+    const int count = std::min(kChunkRows, rowCount(job) - first);
+    if (count <= 0)
+        return out;
+    const auto& table = *job.table;
+
+    std::vector<int> rows(count);
+    if (job.rows.empty())
+        std::iota(rows.begin(), rows.end(), first);
+    else
+        std::copy_n(job.rows.begin() + first, count, rows.begin());
+
+    if (const auto source = textSource(table)) {
+        const int cols = source->colCount();
+        const auto columns = jobColumns(job, cols);
+        std::vector<FastTableData::Value> values;
+        if (job.rows.empty() ? !source->readRows(first, count, values) : !readSourceRows(*source, rows, values))
+            return std::nullopt;
+        for (int r = 0; r < count; ++r) {
+            for (size_t i = 0; i < columns.size(); ++i) {
+                if (i > 0)
+                    out.push_back(job.delimiter);
+                appendValue(out, values[static_cast<size_t>(r) * cols + columns[i]], job.delimiter);
+            }
+            out.push_back('\n');
+        }
+        return out;
+    }
+
+    // Typed columns are formatted from their native values, the others are read once per chunk.
+    const auto columns = jobColumns(job, table.colCount());
+    std::vector<std::vector<FastTableData::Value>> cells(columns.size());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (!table.numericColumn(columns[i]) && !table.readCells(columns[i], rows, cells[i]))
+            return std::nullopt;
+    }
+
+    out.reserve(static_cast<size_t>(count) * columns.size() * 8);
+    for (int r = 0; r < count; ++r) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            if (i > 0)
+                out.push_back(job.delimiter);
+            if (const auto* numeric = table.numericColumn(columns[i])) {
+                std::visit([&out, row = rows[r]](const auto& values) {
+                    using T = typename std::decay_t<decltype(values)>::value_type;
+                    if constexpr (std::is_same_v<T, BFloat16>)
+                        appendNumber(out, static_cast<float>(values[row]));
+                    else
+                        appendNumber(out, values[row]);
+                }, *numeric);
+            } else if (r < static_cast<int>(cells[i].size())) {
+                appendValue(out, cells[i][r], job.delimiter);
+            }
+        }
+        out.push_back('\n');
+    }
+    return out;
+}
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "FastTableData.h"
+
+// Formats table rows as delimited UTF-8 text in independent row chunks, shared by file export and clipboard copy.
+namespace TableTextFormat {
+
+inline constexpr int kChunkRows = 4096;
+
+struct Job {
+    std::shared_ptr<const FastTableData> table;
+    std::vector<int> rows;      // rows in order, empty for all; source rows for paged tables, table rows otherwise
+    std::vector<int> columns;   // columns in order, empty for all
+    char delimiter = ',';
+};
+
+int rowCount(const Job& job);
+std::string formatHeader(const Job& job);
+// Formats rows [first, first + kChunkRows) of the job, one line per row; nothing when the rows could not be read.
+std::optional<std::string> formatChunk(const Job& job, int first);
+
+}
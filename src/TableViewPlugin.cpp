@@ -7,6 +7,9 @@
 #include <DatasetsMimeData.h>
 #include <QDebug>
 #include <QMimeData>
+#include <QProgressBar>
+#include <algorithm>
+#include <iterator>
 
 Q_PLUGIN_METADATA(IID "studio.manivault.TableViewPlugin")
 
@@ -19,7 +22,10 @@ TableViewPlugin::TableViewPlugin(const PluginFactory* factory) :
     _points(),
     _currentDatasetName(),
     //_currentDatasetNameLabel(new QLabel()),
-    _settingsAction(*this)
+    _settingsAction(*this),
+    _ingestor(),
+    _loadProgress(nullptr),
+    _tableCache()
 {
     //_currentDatasetNameLabel->setAcceptDrops(true);
     //_currentDatasetNameLabel->setAlignment(Qt::AlignCenter);
@@ -124,7 +130,8 @@ void TableViewPlugin::init()
         if(_points.isValid())
         { auto newDatasetName = _points->getGuiName();
         _dropWidget->setShowDropIndicator(false);
-        modifyandSetNewPointData();
+        _tableCache.invalidate(_points->getId());
+        scheduleReload();
 
         //qDebug() << "[dataChanged] Exiting. _isUpdatingPoints reset to false.";
         }
@@ -136,12 +143,14 @@ void TableViewPlugin::init()
         if(_settingsAction.getDatasetOptionsHolder().getPointDatasetAction().getCurrentDataset().isValid())
         {
             _points = _settingsAction.getDatasetOptionsHolder().getPointDatasetAction().getCurrentDataset();
-            mv::events().notifyDatasetDataChanged(_points);
+            // Reload here instead of broadcasting a data changed event, which would reach every plugin and invalidate the cached table.
+            scheduleReload();
             //qDebug() << "[currentIndexChanged] _points set to valid dataset.";
         }
         else
         {
             _points = Dataset<Points>();
+            scheduleReload();
             //qDebug() << "[currentIndexChanged] _points set to invalid dataset.";
         }
 
@@ -149,9 +158,26 @@ void TableViewPlugin::init()
 
     _eventListener.addSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetAdded));
     _eventListener.addSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetDataChanged));
+    _eventListener.addSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetAboutToBeRemoved));
     _eventListener.addSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetRemoved));
     _eventListener.addSupportedEventType(static_cast<std::uint32_t>(EventType::DatasetDataSelectionChanged));
     _eventListener.registerDataEventByType(PointType, std::bind(&TableViewPlugin::onDataEvent, this, std::placeholders::_1));
+    _eventListener.registerDataEventByType(ClusterType, std::bind(&TableViewPlugin::onDataEvent, this, std::placeholders::_1));
+
+    _reloadTimer.setSingleShot(true);
+    _reloadTimer.setInterval(0);
+    connect(&_reloadTimer, &QTimer::timeout, this, &TableViewPlugin::flushReload);
+
+    _selectionTimer.setSingleShot(true);
+    _selectionTimer.setInterval(0);
+    connect(&_selectionTimer, &QTimer::timeout, this, &TableViewPlugin::applyDatasetSelection);
+    connect(_settingsAction.getTableViewAction(), &HighPerfTableView::sourceRowsSelected, this, &TableViewPlugin::pushSelection);
+    // A file replaces the dataset's table, a build still streaming in must not overwrite it.
+    connect(_settingsAction.getTableViewAction(), &HighPerfTableView::fileOpened, this, [this]() {
+        _ingestor.cancel();
+        _loadingDatasetId.clear();
+        _shownDatasetId.clear();
+    });
 
     _settingsAction.getTableViewAction()->setBarDelegateForNumericalColumns(true);
 
@@ -161,10 +187,127 @@ void TableViewPlugin::init()
     settings->setContentsMargins(0, 0, 0, 0);
     settings->setSpacing(0);
     settings->addWidget(_settingsAction.getDatasetOptionsHolder().createWidget(&getWidget()));
+    _loadProgress = new QProgressBar();
+    _loadProgress->setRange(0, 100);
+    _loadProgress->setMaximumWidth(220);
+    _loadProgress->setVisible(false);
+    settings->addWidget(_loadProgress);
     layout->addLayout(settings);
-    layout->addWidget(_settingsAction.getTableViewAction(),100);
+    auto tableLayout = new QHBoxLayout();
+    tableLayout->setContentsMargins(0, 0, 0, 0);
+    tableLayout->setSpacing(2);
+    tableLayout->addWidget(_settingsAction.getTableViewAction(), 100);
+    tableLayout->addWidget(_settingsAction.getTableMinimap());
+    layout->addLayout(tableLayout, 100);
     //layout->addWidget(_currentDatasetNameLabel);
     getWidget().setLayout(layout);
+
+    connect(&_ingestor, &TableIngestor::progressChanged, this, [this](int percent, const QString& stage) {
+        _loadProgress->setValue(percent);
+        _loadProgress->setFormat(QString("%1 %p%").arg(stage));
+    });
+    connect(&_ingestor, &TableIngestor::busyChanged, this, [this](bool busy) {
+        _loadProgress->setValue(0);
+        _loadProgress->setVisible(busy);
+    });
+    connect(&_ingestor, &TableIngestor::tableReady, this, [this](const FastTableData& table) {
+        _shownDatasetId = _loadingDatasetId;
+        _settingsAction.getTableViewAction()->setData(table);
+        cacheShownTable();
+    });
+    connect(&_ingestor, &TableIngestor::previewReady, this, [this](const FastTableData& table) {
+        // Sorting would scramble the rows still streaming in, it comes back with the final ranges.
+        _shownDatasetId = _loadingDatasetId;
+        _settingsAction.getTableViewAction()->setData(table);
+        _settingsAction.getTableViewAction()->setSortingEnabled(false);
+    });
+    connect(&_ingestor, &TableIngestor::rowsReady, this, [this](const FastTableData& block) {
+        _settingsAction.getTableViewAction()->appendRows(block);
+    });
+    connect(&_ingestor, &TableIngestor::statsReady, this, [this](const FastTableData& firstRows) {
+        _settingsAction.getTableViewAction()->refineRows(0, firstRows);
+        _settingsAction.getTableViewAction()->setSortingEnabled(true);
+        cacheShownTable();
+    });
+    connect(&_ingestor, &TableIngestor::columnsReady, this, [this](const FastTableData& columns) {
+        // The children changed shape since the table was built, rebuild it as a whole.
+        if (!_settingsAction.getTableViewAction()->replaceColumns(columns)) {
+            _loadingDatasetId.clear();
+            scheduleReload();
+            return;
+        }
+        cacheShownTable();
+    });
+
+    auto& cacheSizeAction = _settingsAction.getDatasetOptionsHolder().getTableCacheSizeAction();
+    _tableCache.setBudget(static_cast<qint64>(cacheSizeAction.getValue()) * 1024 * 1024);
+    connect(&cacheSizeAction, &IntegralAction::valueChanged, this, [this](std::int32_t megabytes) {
+        _tableCache.setBudget(static_cast<qint64>(megabytes) * 1024 * 1024);
+    });
+}
+
+bool TableViewPlugin::showsDataset() const
+{
+    return _points.isValid() && !_shownDatasetId.isEmpty() && _shownDatasetId == _points->getId();
+}
+
+void TableViewPlugin::applyDatasetSelection()
+{
+    if (!showsDataset())
+        return;
+
+    // Selection indices are global, the bitmap is indexed by the rows of this dataset.
+    std::vector<bool> selected;
+    _points->selectedLocalIndices(_points->getSelection<Points>()->indices, selected);
+    _settingsAction.getTableViewAction()->selectSourceRows(selected);
+}
+
+void TableViewPlugin::pushSelection(const std::vector<std::uint32_t>& sourceRows)
+{
+    // Rows of a table opened from a file have nothing to do with the dataset.
+    if (!showsDataset())
+        return;
+
+    const std::uint32_t numPoints = _points->getNumPoints();
+    std::vector<std::uint32_t> indices;
+    indices.reserve(sourceRows.size());
+    std::copy_if(sourceRows.begin(), sourceRows.end(), std::back_inserter(indices), [numPoints](std::uint32_t row) {
+        return row < numPoints;
+    });
+    if (!_points->isFull()) {
+        std::vector<std::uint32_t> globalIndices;
+        _points->getGlobalIndices(globalIndices);
+        indices.erase(std::remove_if(indices.begin(), indices.end(), [&globalIndices](std::uint32_t row) {
+            return row >= globalIndices.size();
+        }), indices.end());
+        for (auto& index : indices)
+            index = globalIndices[index];
+    }
+
+    // The selection event comes straight back to this plugin, it must not be applied to the table again.
+    _pushingSelection = true;
+    _points->setSelectionIndices(indices);
+    mv::events().notifyDatasetDataSelectionChanged(_points);
+    _pushingSelection = false;
+}
+
+void TableViewPlugin::cacheShownTable()
+{
+    // The snapshot shares its columns with the model, later edits in the view copy the columns they touch.
+    if (!_loadingDatasetId.isEmpty())
+        _tableCache.insert(_loadingDatasetId, _loadingVersion, _settingsAction.getTableViewAction()->model()->snapshot());
+    _loadingDatasetId.clear();
+    applyRestoredViewState();
+    // A new table starts without selection.
+    _selectionTimer.start();
+}
+
+void TableViewPlugin::applyRestoredViewState()
+{
+    if (_restoredViewStateDatasetId.isEmpty() || !_points.isValid() || _points->getId() != _restoredViewStateDatasetId)
+        return;
+    TableState::apply(*_settingsAction.getTableViewAction(), _restoredViewState);
+    _restoredViewStateDatasetId.clear();
 }
 
 void TableViewPlugin::setShowBarsForNumericalColumns(bool enabled)
@@ -178,103 +321,30 @@ void TableViewPlugin::modifyandSetNewPointData()
     //qDebug() << "[modifyandSetPointData] _points.isValid():" << _points.isValid();
     if (_points.isValid()) {
         _dropWidget->setShowDropIndicator(false);
-        int numOfDims = _points->getNumDimensions();
-        int numOfRows = _points->getNumPoints();
-        std::vector<QString> columnNames = _points->getDimensionNames();
-        std::vector<int> columnIndices;
-
-        for (int i = 0; i < numOfDims; ++i) {
-            columnIndices.push_back(i);
-        }
-        std::vector<float> xData(numOfRows * numOfDims);
-        _points->populateDataForDimensions(xData, columnIndices);
-
-        auto children = _points->getChildren();
-        std::vector<std::vector<QString>> clusterDataset;
-        std::vector<QString> clusterColumnNames;
-        std::vector<std::map<QString, QString>> clusterColorMap;
-
-        for (const Dataset<Clusters>& child : children) {
-            if (child->getDataType() == ClusterType) {
-                std::vector<QString> clusterInfo(numOfRows, QString());
-                std::map<QString, QString> colorMapForThisColumn;
-                clusterColumnNames.push_back(child->getGuiName());
-                auto clusterValues = child->getClusters();
-
-                for (const auto& clusterValue : clusterValues) {
-                    auto clusterName = clusterValue.getName();
-                    auto clusterIndices = clusterValue.getIndices();
-                    QString clusterColor = clusterValue.getColor().name();
-
-                    if (!clusterName.isEmpty() && !clusterColor.isEmpty()) {
-                        if (colorMapForThisColumn.find(clusterName) == colorMapForThisColumn.end()) {
-                            colorMapForThisColumn[clusterName] = clusterColor;
-                        }
-                    }
 
-                    for (const auto& index : clusterIndices) {
-                        if (index < numOfRows) {
-                            clusterInfo[index] = clusterName;
-                        }
-                    }
-                }
-                clusterDataset.push_back(clusterInfo);
-                clusterColorMap.push_back(colorMapForThisColumn);
-            }
+        // Switching back to a recently shown dataset reuses its built table.
+        const QString datasetId = _points->getId();
+        if (const auto cached = _tableCache.find(datasetId, _tableCache.version(datasetId))) {
+            _ingestor.cancel();
+            _loadingDatasetId.clear();
+            _shownDatasetId = datasetId;
+            _settingsAction.getTableViewAction()->setData(*cached);
+            _settingsAction.getTableViewAction()->setSortingEnabled(true);
+            applyRestoredViewState();
+            _selectionTimer.start();
+            return;
         }
 
-        std::vector<std::vector<QString>> clusterDatasetRows(numOfRows);
-        for (int r = 0; r < numOfRows; ++r) {
-            clusterDatasetRows[r].resize(clusterDataset.size());
-            for (size_t c = 0; c < clusterDataset.size(); ++c) {
-                clusterDatasetRows[r][c] = clusterDataset[c][r];
-            }
-        }
-
-        for (const Dataset<Points>& child : children)
-        {
-            if (child->getDataType() == PointType) {
-                //qDebug() << "[modifyandSetPointData] Found child dataset of type PointType:" << child->getGuiName();
-                auto childColumnNames = child->getDimensionNames();
-                int childNumOfDims = child->getNumDimensions();
-                int childNumOfRows = child->getNumPoints();
-                std::vector<int> childColumnIndices;
-                for (int i = 0; i < childNumOfDims; ++i) {
-                    childColumnIndices.push_back(i);
-                }
-                std::vector<float> childXData(childNumOfRows * childNumOfDims);
-                child->populateDataForDimensions(childXData, childColumnIndices);
-
-                if (childNumOfRows == numOfRows && childNumOfDims > 0) {
-                    int oldNumCols = numOfDims;
-                    int newNumCols = numOfDims + childNumOfDims;
-                    std::vector<float> mergedXData(numOfRows * newNumCols);
-
-                    for (int row = 0; row < numOfRows; ++row) {
-                        for (int col = 0; col < numOfDims; ++col) {
-                            mergedXData[row * newNumCols + col] = xData[row * numOfDims + col];
-                        }
-                    }
-                    for (int row = 0; row < numOfRows; ++row) {
-                        for (int col = 0; col < childNumOfDims; ++col) {
-                            mergedXData[row * newNumCols + (numOfDims + col)] = childXData[row * childNumOfDims + col];
-                        }
-                    }
-                    xData = std::move(mergedXData);
-                    columnNames.insert(columnNames.end(), childColumnNames.begin(), childColumnNames.end());
-                    numOfDims = newNumCols;
-                }
-            }
-        }
-
-        FastTableData fastData = createTableFromDatasetData(
-            xData, numOfRows, columnNames, clusterDatasetRows, clusterColumnNames, clusterColorMap);
-        _settingsAction.getTableViewAction()->setData(fastData);
-
-        //qDebug() << "[modifyandSetPointData] Table data set with" << numOfRows << "rows and" << numOfDims << "columns.";
+        // The current table stays up until the ingestor publishes the new one.
+        _loadingDatasetId = datasetId;
+        _loadingVersion = _tableCache.version(datasetId);
+        _ingestor.load(_points);
     }
     else {
         //qDebug() << "[modifyandSetPointData] No valid points dataset, clearing table.";
+        _ingestor.cancel();
+        _loadingDatasetId.clear();
+        _shownDatasetId.clear();
         _settingsAction.getTableViewAction()->setData(FastTableData());
         _dropWidget->setShowDropIndicator(true);
     }
@@ -283,35 +353,74 @@ void TableViewPlugin::modifyandSetNewPointData()
 void TableViewPlugin::onDataEvent(mv::DatasetEvent* dataEvent)
 {
     const auto changedDataSet = dataEvent->getDataset();
-    if (!changedDataSet.isValid() || changedDataSet->getDataType() != PointType) {
-        //qDebug() << "Received data event for an invalid or non-PointType dataset, ignoring.";
+    if (!changedDataSet.isValid() || (changedDataSet->getDataType() != PointType && changedDataSet->getDataType() != ClusterType)) {
+        //qDebug() << "Received data event for an invalid or unsupported dataset, ignoring.";
         return;
     }
     const auto datasetGuiName = changedDataSet->getGuiName();
+    const bool isShown = _points.isValid() && changedDataSet->getId() == _points->getId();
+    const bool isShownChild = _points.isValid() && changedDataSet->getParent().isValid() && changedDataSet->getParent()->getId() == _points->getId();
 
     switch (dataEvent->getType()) {
         case EventType::DatasetAdded:
         {
             const auto dataAddedEvent = static_cast<DatasetAddedEvent*>(dataEvent);
+            // A new child adds columns to the shown table.
+            if (isShownChild) {
+                _tableCache.invalidate(_points->getId());
+                scheduleReload();
+            }
             //qDebug() << datasetGuiName << "was added";
             break;
         }
         case EventType::DatasetDataChanged:
         {
             const auto dataChangedEvent = static_cast<DatasetDataChangedEvent*>(dataEvent);
+            // The shown dataset is invalidated right before its reload; tables of the parent include this dataset as child columns.
+            if (!isShown)
+                _tableCache.invalidate(changedDataSet->getId());
+            if (changedDataSet->getParent().isValid())
+                _tableCache.invalidate(changedDataSet->getParent()->getId());
+            if (isShownChild)
+                scheduleColumnReload(changedDataSet->getId());
             //qDebug() << datasetGuiName << "data changed";
             break;
         }
+        case EventType::DatasetAboutToBeRemoved:
+        {
+            // Workers still reading the dataset or its children must stop before their data is torn down.
+            if (isShown || isShownChild) {
+                _ingestor.cancelAndWait();
+                _loadingDatasetId.clear();
+                if (showsDataset()) {
+                    _settingsAction.getTableMinimap()->cancelAndWait();
+                    _settingsAction.getTableViewAction()->releaseData();
+                    _shownDatasetId.clear();
+                }
+            }
+            _tableCache.remove(changedDataSet->getId());
+            if (changedDataSet->getParent().isValid())
+                _tableCache.invalidate(changedDataSet->getParent()->getId());
+            break;
+        }
         case EventType::DatasetRemoved:
         {
             const auto dataRemovedEvent = static_cast<DatasetRemovedEvent*>(dataEvent);
+            _tableCache.remove(changedDataSet->getId());
+            if (changedDataSet->getParent().isValid())
+                _tableCache.invalidate(changedDataSet->getParent()->getId());
+            if (isShown)
+                _ingestor.cancel();
+            else if (isShownChild)
+                scheduleReload();
             //qDebug() << datasetGuiName << "was removed";
             break;
         }
         case EventType::DatasetDataSelectionChanged:
         {
             const auto dataSelectionChangedEvent = static_cast<DatasetDataSelectionChangedEvent*>(dataEvent);
-            const auto& selectionSet = changedDataSet->getSelection<Points>();
+            if (isShown && !_pushingSelection)
+                _selectionTimer.start();
             //qDebug() << datasetGuiName << "selection has changed";
             break;
         }
@@ -320,6 +429,53 @@ void TableViewPlugin::onDataEvent(mv::DatasetEvent* dataEvent)
     }
 }
 
+void TableViewPlugin::scheduleReload()
+{
+    _fullReloadPending = true;
+    _reloadTimer.start();
+}
+
+void TableViewPlugin::scheduleColumnReload(const QString& datasetId)
+{
+    if (!_pendingColumnOrigins.contains(datasetId))
+        _pendingColumnOrigins.append(datasetId);
+    _reloadTimer.start();
+}
+
+void TableViewPlugin::flushReload()
+{
+    // Everything requested since the last event loop turn is handled in one rebuild.
+    const bool fullReload = _fullReloadPending;
+    const QStringList origins = _pendingColumnOrigins;
+    _fullReloadPending = false;
+    _pendingColumnOrigins.clear();
+
+    if (fullReload || !_points.isValid()) {
+        modifyandSetNewPointData();
+        return;
+    }
+    if (origins.isEmpty())
+        return;
+
+    // Only children changed: rebuild just their columns when the shown table holds them, a build in flight restarts instead.
+    const auto table = _settingsAction.getTableViewAction()->model()->snapshot();
+    bool partial = !_ingestor.isBusy() && !table->hasRowSource() && !table->hasColumnSource();
+    for (const auto& origin : origins) {
+        bool shown = false;
+        for (int c = 0; c < table->colCount() && !shown; ++c)
+            shown = table->columnOrigin(c) == origin;
+        partial = partial && shown;
+    }
+    if (!partial) {
+        modifyandSetNewPointData();
+        return;
+    }
+
+    _loadingDatasetId = _points->getId();
+    _loadingVersion = _tableCache.version(_loadingDatasetId);
+    _ingestor.loadColumns(_points, origins);
+}
+
 TableViewPluginFactory::TableViewPluginFactory()
 {
     setIconByName("table");
@@ -356,6 +512,16 @@ mv::gui::PluginTriggerActions TableViewPluginFactory::getPluginTriggerActions(co
 void TableViewPlugin::fromVariantMap(const QVariantMap& variantMap)
 {
     ViewPlugin::fromVariantMap(variantMap);
+
+    // A stored table is shown straight from the project once its dataset is picked, without reading the dataset.
+    TableState::Saved saved;
+    if (TableState::restore(variantMap.value("TableViewPlugin:TableState").toByteArray(), saved)) {
+        if (saved.table)
+            _tableCache.insert(saved.datasetId, _tableCache.version(saved.datasetId), saved.table);
+        _restoredViewState = saved.view;
+        _restoredViewStateDatasetId = saved.datasetId;
+    }
+
     mv::util::variantMapMustContain(variantMap, "TableViewPlugin:Settings");
     _settingsAction.fromVariantMap(variantMap["TableViewPlugin:Settings"].toMap());
 }
@@ -365,5 +531,11 @@ QVariantMap TableViewPlugin::toVariantMap() const
     QVariantMap variantMap = ViewPlugin::toVariantMap();
 
     _settingsAction.insertIntoVariantMap(variantMap);
+    // Content is only stored for a completed build of the current dataset version, which is then in the cache;
+    // a file or a table still streaming in only leaves its view state.
+    const QString datasetId = _points.isValid() ? _points->getId() : QString();
+    const bool withContent = showsDataset() && _loadingDatasetId.isEmpty()
+        && _tableCache.peek(datasetId, _tableCache.version(datasetId)) != nullptr;
+    variantMap.insert("TableViewPlugin:TableState", TableState::save(*_settingsAction.getTableViewAction(), datasetId, withContent));
     return variantMap;
 }
\ No newline at end of file
@@ -6,15 +6,21 @@
 #include <PointData/PointData.h>
 #include <ClusterData/ClusterData.h>
 #include <QWidget>
+#include <QTimer>
+#include <QStringList>
 #include "HighPerfTableView.h"
 #include "FastTableData.h"
 #include "SettingsAction.h"
+#include "TableIngestor.h"
+#include "TableCache.h"
+#include "TableState.h"
 
 using namespace mv::plugin;
 using namespace mv::gui;
 using namespace mv::util;
 
 class QLabel;
+class QProgressBar;
 
 class TableViewPlugin : public ViewPlugin
 {
@@ -29,6 +35,22 @@ public:
     void setShowBarsForNumericalColumns(bool enabled);
     void modifyandSetNewPointData();
 
+private:
+    void cacheShownTable();
+    // Applies the view state stored in the project once the table of its dataset is shown.
+    void applyRestoredViewState();
+
+    // Dataset events are coalesced into one rebuild per event loop turn, of the whole table or of some child columns.
+    void scheduleReload();
+    void scheduleColumnReload(const QString& datasetId);
+    void flushReload();
+
+    // Selection linking with the dataset: incoming changes are coalesced per event loop turn, outgoing ones come debounced from the view.
+    void applyDatasetSelection();
+    void pushSelection(const std::vector<std::uint32_t>& sourceRows);
+    // Whether the shown table was built from _points, and not opened from a file.
+    bool showsDataset() const;
+
 public:
     void fromVariantMap(const QVariantMap& variantMap) override;
     QVariantMap toVariantMap() const override;
@@ -39,6 +61,19 @@ protected:
     QString                 _currentDatasetName;
     //QLabel*                 _currentDatasetNameLabel;
     SettingsAction          _settingsAction;
+    TableIngestor           _ingestor;
+    QProgressBar*           _loadProgress;
+    TableCache              _tableCache;
+    QString                 _loadingDatasetId;      // dataset of the build in flight
+    QString                 _shownDatasetId;        // dataset the shown table was built from, empty for files
+    quint64                 _loadingVersion = 0;    // its cache version when the build started
+    QTimer                  _reloadTimer;
+    bool                    _fullReloadPending = false;
+    QStringList             _pendingColumnOrigins;  // child datasets whose columns need a rebuild
+    QTimer                  _selectionTimer;
+    bool                    _pushingSelection = false;
+    TableState::ViewState   _restoredViewState;
+    QString                 _restoredViewStateDatasetId;
 
 };
 
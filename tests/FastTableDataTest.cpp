@@ -0,0 +1,35 @@
+#include <QtTest>
+#include "FastTableData.h"
+
+// Unit tests of FastTableData that need no ManiVault core.
+class FastTableDataTest : public QObject {
+    Q_OBJECT
+private slots:
+    void sortTypedColumn();
+};
+
+void FastTableDataTest::sortTypedColumn()
+{
+    // Typed columns carry no per-cell colors; sorting must only permute their values.
+    FastTableData table(4, 0);
+    table.appendNumericColumn("float", std::vector<float>{ 3.0f, 1.0f, 4.0f, 2.0f });
+    table.appendNumericColumn("int", std::vector<std::int32_t>{ 30, 10, 40, 20 });
+    table.appendColumn("label", { QString("c"), QString("a"), QString("d"), QString("b") }, false);
+
+    table.permuteRows(table.sortedRowOrder(0, true));
+
+    QCOMPARE(std::get<double>(table.get(0, 0)), 1.0);
+    QCOMPARE(std::get<double>(table.get(3, 0)), 4.0);
+    QCOMPARE(std::get<int>(table.get(0, 1)), 10);
+    QCOMPARE(std::get<int>(table.get(3, 1)), 40);
+    QCOMPARE(std::get<QString>(table.get(0, 2)), QString("a"));
+    QCOMPARE(table.sourceRow(0), 1);
+    QCOMPARE(table.sourceRow(3), 2);
+
+    table.permuteRows(table.sortedRowOrder(1, false));
+    QCOMPARE(std::get<int>(table.get(0, 1)), 40);
+    QCOMPARE(table.sourceRow(0), 2);
+}
+
+QTEST_GUILESS_MAIN(FastTableDataTest)
+#include "FastTableDataTest.moc"
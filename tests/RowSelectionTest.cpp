@@ -0,0 +1,64 @@
+#include <QtTest>
+#include <QStandardItemModel>
+#include "RowSelection.h"
+
+// Merged row ranges of a selection and the rows and values they map to.
+class RowSelectionTest : public QObject {
+    Q_OBJECT
+private slots:
+    void mergeRanges();
+    void fromItemSelection();
+    void sortedValues();
+};
+
+void RowSelectionTest::mergeRanges()
+{
+    // Overlapping and adjacent ranges merge, reversed ones are dropped.
+    const RowSelection selection({ { 5, 7 }, { 0, 2 }, { 3, 3 }, { 10, 9 }, { 6, 12 } }, nullptr);
+    QCOMPARE(selection.ranges(), (std::vector<std::pair<int, int>>{ { 0, 3 }, { 5, 12 } }));
+    QCOMPARE(selection.rowCount(), 12);
+    QVERIFY(selection.contains(0));
+    QVERIFY(!selection.contains(4));
+    QVERIFY(selection.contains(12));
+    QVERIFY(!selection.contains(13));
+
+    QCOMPARE(selection.row(0), 0);
+    QCOMPARE(selection.row(3), 3);
+    QCOMPARE(selection.row(4), 5);
+    QCOMPARE(selection.row(11), 12);
+    QCOMPARE(selection.row(12), -1);
+    QCOMPARE(selection.sourceRow(0), -1);
+
+    QVERIFY(RowSelection().isEmpty());
+}
+
+void RowSelectionTest::fromItemSelection()
+{
+    QStandardItemModel model(20, 2);
+    QItemSelection itemSelection;
+    itemSelection.select(model.index(8, 0), model.index(9, 1));
+    itemSelection.select(model.index(2, 0), model.index(4, 1));
+    itemSelection.select(model.index(5, 0), model.index(5, 0));
+
+    const RowSelection selection = RowSelection::fromItemSelection(itemSelection, nullptr);
+    QCOMPARE(selection.ranges(), (std::vector<std::pair<int, int>>{ { 2, 5 }, { 8, 9 } }));
+    QCOMPARE(selection.rowCount(), 6);
+}
+
+void RowSelectionTest::sortedValues()
+{
+    // Selected rows are table rows; values and source rows follow the sort order.
+    auto table = std::make_shared<FastTableData>(4, 0);
+    table->appendNumericColumn("int", std::vector<std::int32_t>{ 30, 10, 40, 20 });
+    table->permuteRows(table->sortedRowOrder(0, true));
+
+    const RowSelection selection({ { 1, 2 } }, table);
+    QCOMPARE(std::get<int>(selection.value(0, 0)), 20);
+    QCOMPARE(selection.sourceRow(0), 3);
+    QCOMPARE(std::get<int>(selection.value(1, 0)), 30);
+    QCOMPARE(selection.sourceRow(1), 0);
+    QCOMPARE(selection.sourceRow(2), -1);
+}
+
+QTEST_GUILESS_MAIN(RowSelectionTest)
+#include "RowSelectionTest.moc"
@@ -0,0 +1,69 @@
+#include <QtTest>
+#include "ScrollMapper.h"
+
+// Mapping of logical pixel positions onto the bounded scrollbar range.
+class ScrollMapperTest : public QObject {
+    Q_OBJECT
+private slots:
+    void smallTable();
+    void hugeTable();
+};
+
+void ScrollMapperTest::smallTable()
+{
+    // Below the scrollbar limit one step is one pixel.
+    ScrollMapper mapper;
+    mapper.setGeometry(100, 20, 500);
+    QCOMPARE(mapper.maximumTopPixel(), qint64(1500));
+    QCOMPARE(mapper.scrollBarMaximum(), 1500);
+    QCOMPARE(mapper.scrollBarPageStep(), 500);
+
+    mapper.setScrollBarValue(700);
+    QCOMPARE(mapper.topPixel(), qint64(700));
+    QCOMPARE(mapper.topRow(), qint64(35));
+    QCOMPARE(mapper.topRowPixelOffset(), 0);
+
+    mapper.scrollByPixels(-15);
+    QCOMPARE(mapper.topRow(), qint64(34));
+    QCOMPARE(mapper.topRowPixelOffset(), 5);
+    QCOMPARE(mapper.scrollBarValue(), 685);
+
+    mapper.scrollByPixels(1000000);
+    QCOMPARE(mapper.topPixel(), qint64(1500));
+
+    // Fewer rows clamp the position.
+    mapper.setGeometry(30, 20, 500);
+    QCOMPARE(mapper.topPixel(), qint64(100));
+    mapper.setGeometry(10, 20, 500);
+    QCOMPARE(mapper.topPixel(), qint64(0));
+    QCOMPARE(mapper.scrollBarMaximum(), 0);
+}
+
+void ScrollMapperTest::hugeTable()
+{
+    // Three billion rows span more pixels than the scrollbar range, one step covers many pixels.
+    ScrollMapper mapper;
+    mapper.setGeometry(3000000000LL, 20, 600);
+    const qint64 maxTop = 3000000000LL * 20 - 600;
+    QCOMPARE(mapper.maximumTopPixel(), maxTop);
+    QCOMPARE(mapper.scrollBarMaximum(), ScrollMapper::kMaxScrollBarRange);
+    QVERIFY(mapper.scrollBarPageStep() >= 1);
+
+    mapper.setScrollBarValue(ScrollMapper::kMaxScrollBarRange);
+    QCOMPARE(mapper.topPixel(), maxTop);
+    QCOMPARE(mapper.topRow(), maxTop / 20);
+
+    // Relative scrolling stays pixel precise, and setting the value the bar already shows does not move it.
+    mapper.setScrollBarValue(1000);
+    const qint64 anchored = mapper.topPixel();
+    mapper.scrollByPixels(1);
+    QCOMPARE(mapper.topPixel(), anchored + 1);
+    mapper.setScrollBarValue(mapper.scrollBarValue());
+    QCOMPARE(mapper.topPixel(), anchored + 1);
+
+    mapper.setScrollBarValue(0);
+    QCOMPARE(mapper.topPixel(), qint64(0));
+}
+
+QTEST_GUILESS_MAIN(ScrollMapperTest)
+#include "ScrollMapperTest.moc"
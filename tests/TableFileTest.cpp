@@ -0,0 +1,106 @@
+#include <QtTest>
+#include <cmath>
+#include <limits>
+#include "TableFile.h"
+#include "TableFileSource.h"
+
+// Writes tables in the .mvtab layout in memory and reads them back through TableFileSource.
+class TableFileTest : public QObject {
+    Q_OBJECT
+private slots:
+    void roundTrip();
+    void selectedRows();
+    void rejectTruncated();
+
+private:
+    static FastTableData makeTable();
+};
+
+FastTableData TableFileTest::makeTable()
+{
+    FastTableData table(4, 0);
+    table.appendNumericColumn("float", std::vector<float>{ 1.5f, -2.0f, 4.0f, 0.25f });
+    table.appendNumericColumn("short", std::vector<std::int16_t>{ 3, -7, 0, 12 });
+    table.appendColumn("label", { QString("b"), QString("a"), QString("b"), QString("c") }, false, { { QString("a"), QColor(Qt::red) } });
+    table.appendColumn("value", { 1.0, 2.0, std::numeric_limits<double>::quiet_NaN(), 3.5 }, true);
+    return table;
+}
+
+void TableFileTest::roundTrip()
+{
+    const QByteArray bytes = TableFile::encode(makeTable());
+    QVERIFY(!bytes.isEmpty());
+
+    const TableFileSource source(bytes);
+    QVERIFY(source.isValid());
+    QCOMPARE(source.rowCount(), 4);
+    QCOMPARE(source.colCount(), 4);
+    QCOMPARE(source.columnName(1), QString("short"));
+    QVERIFY(source.columnIsNumeric(0));
+    QVERIFY(!source.columnIsNumeric(2));
+    QCOMPARE(source.columnLabelColors(2).at("a"), QColor(Qt::red));
+
+    // Ranges are measured while writing, skipping missing values.
+    double minVal = 0.0, maxVal = 0.0;
+    QVERIFY(source.columnRange(0, minVal, maxVal));
+    QCOMPARE(minVal, -2.0);
+    QCOMPARE(maxVal, 4.0);
+    QVERIFY(source.columnRange(3, minVal, maxVal));
+    QCOMPARE(minVal, 1.0);
+    QCOMPARE(maxVal, 3.5);
+    QVERIFY(!source.columnRange(2, minVal, maxVal));
+
+    // Typed columns keep their element type.
+    NumericBuffer buffer;
+    QVERIFY(source.readNumericColumn(1, buffer));
+    QVERIFY(std::holds_alternative<std::vector<std::int16_t>>(buffer));
+    QCOMPARE(std::get<std::vector<std::int16_t>>(buffer), (std::vector<std::int16_t>{ 3, -7, 0, 12 }));
+    QVERIFY(!source.readNumericColumn(2, buffer));
+
+    std::vector<FastTableData::Value> values;
+    QVERIFY(source.readColumn(2, values));
+    QCOMPARE(values.size(), size_t(4));
+    QCOMPARE(std::get<QString>(values[0]), QString("b"));
+    QCOMPARE(std::get<QString>(values[1]), QString("a"));
+    QCOMPARE(std::get<QString>(values[3]), QString("c"));
+
+    QVERIFY(source.readColumn(3, values));
+    QVERIFY(std::isnan(std::get<double>(values[2])));
+    QCOMPARE(std::get<double>(values[3]), 3.5);
+
+    QVERIFY(source.readColumnRows(0, { 3, 0 }, values));
+    QCOMPARE(std::get<double>(values[0]), 0.25);
+    QCOMPARE(std::get<double>(values[1]), 1.5);
+    QVERIFY(!source.readColumnRows(0, { 4 }, values));
+}
+
+void TableFileTest::selectedRows()
+{
+    // Rows are written in the given order; a sorted table writes its rows as shown.
+    FastTableData table = makeTable();
+    const TableFileSource picked(TableFile::encode(table, { 2, 0 }));
+    QVERIFY(picked.isValid());
+    QCOMPARE(picked.rowCount(), 2);
+
+    std::vector<FastTableData::Value> values;
+    QVERIFY(picked.readColumn(1, values));
+    QCOMPARE(std::get<int>(values[0]), 0);
+    QCOMPARE(std::get<int>(values[1]), 3);
+
+    table.permuteRows(table.sortedRowOrder(1, true));
+    const TableFileSource sorted(TableFile::encode(table));
+    QVERIFY(sorted.readColumn(2, values));
+    QCOMPARE(std::get<QString>(values[0]), QString("a"));
+    QCOMPARE(std::get<QString>(values[3]), QString("c"));
+}
+
+void TableFileTest::rejectTruncated()
+{
+    QByteArray bytes = TableFile::encode(makeTable());
+    bytes.chop(1);
+    QVERIFY(!TableFileSource(bytes).isValid());
+    QVERIFY(!TableFileSource(QByteArray()).isValid());
+}
+
+QTEST_GUILESS_MAIN(TableFileTest)
+#include "TableFileTest.moc"
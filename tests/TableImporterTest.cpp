@@ -0,0 +1,130 @@
+#include <QtTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include <cmath>
+#include "FileRowSource.h"
+#include "TableImporter.h"
+
+// Parses small CSV/TSV files through the importer and the paged file source.
+class TableImporterTest : public QObject {
+    Q_OBJECT
+private slots:
+    void inferTypes();
+    void quotedFields();
+    void quotedFieldsAcrossChunks();
+    void pageQuotedFields();
+
+private:
+    QString writeFile(const QString& name, const QByteArray& contents);
+    // The published tables in order: the whole table, or the preview followed by the row blocks.
+    std::vector<FastTableData> import(const QString& filePath);
+
+    QTemporaryDir _dir;
+};
+
+QString TableImporterTest::writeFile(const QString& name, const QByteArray& contents)
+{
+    const QString filePath = _dir.filePath(name);
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(contents) != contents.size())
+        return {};
+    return filePath;
+}
+
+std::vector<FastTableData> TableImporterTest::import(const QString& filePath)
+{
+    std::vector<FastTableData> blocks;
+    TableImporter importer;
+    connect(&importer, &TableImporter::tableReady, this, [&blocks](const FastTableData& table) { blocks.push_back(table); });
+    connect(&importer, &TableImporter::previewReady, this, [&blocks](const FastTableData& table) { blocks.push_back(table); });
+    connect(&importer, &TableImporter::rowsReady, this, [&blocks](const FastTableData& table) { blocks.push_back(table); });
+
+    QSignalSpy finished(&importer, &TableImporter::finished);
+    if (!importer.start(filePath) || !finished.wait(30000) || !finished.at(0).at(0).toBool())
+        return {};
+    return blocks;
+}
+
+void TableImporterTest::inferTypes()
+{
+    // No comma in the header, so the tab delimiter is guessed; CRLF line breaks are dropped.
+    const auto blocks = import(writeFile("types.csv", "a\tb\tc\r\n1\t1.5\tx\r\n-2\t3\ty\r\n"));
+    QCOMPARE(blocks.size(), size_t(1));
+    const FastTableData& table = blocks[0];
+
+    QCOMPARE(table.rowCount(), 2);
+    QCOMPARE(table.colCount(), 3);
+    QCOMPARE(table.columnName(2), QString("c"));
+    QCOMPARE(std::get<int>(table.get(1, 0)), -2);
+    QCOMPARE(std::get<double>(table.get(0, 1)), 1.5);
+    QCOMPARE(std::get<double>(table.get(1, 1)), 3.0);
+    QCOMPARE(std::get<QString>(table.get(1, 2)), QString("y"));
+    QVERIFY(!table.columnIsNumeric(2));
+
+    double minVal = 0.0, maxVal = 0.0;
+    table.getColumnMinMax(0, minVal, maxVal);
+    QCOMPARE(minVal, -2.0);
+    QCOMPARE(maxVal, 1.0);
+}
+
+void TableImporterTest::quotedFields()
+{
+    const auto blocks = import(writeFile("quoted.csv", "id,name,score\n1,\"Smith, J\",2.5\n2,\"two\nlines\",NA\n3,\"say \"\"hi\"\"\",\n"));
+    QCOMPARE(blocks.size(), size_t(1));
+    const FastTableData& table = blocks[0];
+
+    QCOMPARE(table.rowCount(), 3);
+    QCOMPARE(std::get<int>(table.get(2, 0)), 3);
+    QCOMPARE(std::get<QString>(table.get(0, 1)), QString("Smith, J"));
+    QCOMPARE(std::get<QString>(table.get(1, 1)), QString("two\nlines"));
+    QCOMPARE(std::get<QString>(table.get(2, 1)), QString("say \"hi\""));
+    QCOMPARE(std::get<double>(table.get(0, 2)), 2.5);
+    QVERIFY(std::isnan(std::get<double>(table.get(1, 2))));
+    QVERIFY(std::isnan(std::get<double>(table.get(2, 2))));
+}
+
+void TableImporterTest::quotedFieldsAcrossChunks()
+{
+    // Enough rows for more than one parallel chunk; most bytes lie inside quotes, so the chunk boundaries do as well.
+    constexpr int rows = 400000;
+    const QByteArray text(24, 'a');
+    QByteArray contents = "id,text\n";
+    for (int r = 0; r < rows; ++r)
+        contents += QByteArray::number(r) + ",\"" + text + "\n" + text + "\"\n";
+
+    const auto blocks = import(writeFile("chunks.csv", contents));
+    QVERIFY(blocks.size() > 1);
+
+    const QString expected = QString::fromLatin1(text + "\n" + text);
+    int row = 0;
+    for (const FastTableData& block : blocks) {
+        for (int r = 0; r < block.rowCount(); ++r, ++row) {
+            QCOMPARE(std::get<int>(block.get(r, 0)), row);
+            QCOMPARE(std::get<QString>(block.get(r, 1)), expected);
+        }
+    }
+    QCOMPARE(row, rows);
+}
+
+void TableImporterTest::pageQuotedFields()
+{
+    const FileRowSource source(writeFile("paged.csv", "id,name,score\n1,\"Smith, J\",2.5\n2,\"two\nlines\",NA\n3,\"say \"\"hi\"\"\",\n"));
+    QVERIFY(source.isValid());
+    QCOMPARE(source.rowCount(), 3);
+    QVERIFY(source.columnIsNumeric(2));
+
+    std::vector<FastTableData::Value> values;
+    QVERIFY(source.readRows(0, 3, values));
+    QCOMPARE(std::get<QString>(values[1]), QString("Smith, J"));
+    QCOMPARE(std::get<QString>(values[4]), QString("two\nlines"));
+    QCOMPARE(std::get<QString>(values[7]), QString("say \"hi\""));
+    QCOMPARE(std::get<double>(values[2]), 2.5);
+    QVERIFY(std::get<QString>(values[5]).isEmpty());
+
+    QVERIFY(source.readRows(2, 1, values));
+    QCOMPARE(std::get<double>(values[0]), 3.0);
+    QVERIFY(!source.readRows(2, 2, values));
+}
+
+QTEST_GUILESS_MAIN(TableImporterTest)
+#include "TableImporterTest.moc"